@@ -1,22 +1,162 @@
 #include "Application.hpp"
 #include "Content.hpp"
+#include "FileWatcher.hpp"
 #include "Journal.hpp"
+#include "Json.hpp"
+#include "Lighting.hpp"
+#include "Memory.hpp"
 #include "Renderer.hpp"
+#include "Replay.hpp"
 #include "Tags.hpp"
 #include "Window.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <exception>
 #include <string>
 
 namespace Application {
 
-static auto process_events(Application& app) {
+static constexpr char ResourcesFilepath[] = "../assets/resources.json";
+
+// Reloads only what the changed files touch and remeshes only the chunk sections
+// holding blocks whose type or textures changed.
+static auto reload_resources(const Configuration& conf, Application& app, const std::vector<std::string>& files) -> void {
+    auto& atlas = app._renderer._texture_atlas;
+    auto block_types = app._renderer._block_types;
+
+    std::vector<uint32_t> textures;
+    std::vector<uint32_t> blocks;
+
+    for (const auto& file : files) {
+        if (file == ResourcesFilepath) {
+            const auto content = Content::read<std::string>(file);
+            if (!content || !Json::accept(*content)) {
+                Journal::error(Tags::App, "Failed to parse '{}', keeping the current resources", file);
+                continue;
+            }
+
+            // Valid JSON can still miss required fields or name textures the list lacks;
+            // both parse it fully before changing anything
+            Game::BlockTypes updated;
+            std::vector<uint32_t> changed;
+            try {
+                updated = Game::get_block_types(*content);
+                changed = Graphics::update_texture_list(atlas, *content);
+            } catch (const std::exception& e) {
+                Journal::error(Tags::App, "Invalid resources in '{}': {}, keeping the current ones", file, e.what());
+                continue;
+            }
+
+            textures.insert(std::end(textures), std::begin(changed), std::end(changed));
+
+            const auto diff = Game::diff_block_types(block_types, updated);
+            blocks.insert(std::end(blocks), std::begin(diff), std::end(diff));
+            block_types = std::move(updated);
+        } else if (const auto texture = Graphics::reload_texture(atlas, file); texture) {
+            textures.push_back(*texture);
+        }
+    }
+
+    for (const auto texture : textures) {
+        const auto users = Game::get_blocks_using_texture(block_types, texture);
+        blocks.insert(std::end(blocks), std::begin(users), std::end(users));
+    }
+
+    std::sort(std::begin(blocks), std::end(blocks));
+    blocks.erase(std::unique(std::begin(blocks), std::end(blocks)), std::end(blocks));
+
+    // Unrelated files, such as texture caches written next to the assets
+    if (textures.empty() && blocks.empty()) {
+        return;
+    }
+
+    if (conf.compress_textures && !textures.empty()) {
+        Graphics::compress_texture_atlas(atlas, conf.texture_compression);
+    }
+
+    // Light levels that changed need relighting before the meshes are rebuilt
+    std::vector<uint32_t> relit;
+    for (const auto block : blocks) {
+        const auto old_light = block < std::size(app._renderer._block_types) ? app._renderer._block_types[block].light : 0;
+        const auto new_light = block < std::size(block_types) ? block_types[block].light : 0;
+        if (old_light != new_light) {
+            relit.push_back(block);
+        }
+    }
+
+    app._renderer._block_types = std::move(block_types);
+
+    Game::relight_blocks(app._world, app._renderer._block_types, relit);
+    const auto chunks = Game::mark_blocks_dirty(app._world, blocks);
+
+    // Blocks that became fluids or started falling need a tick to move
+    for (const auto& position : chunks) {
+        Game::schedule_chunk(app._world._simulation, *Game::find_chunk(app._world, position), app._renderer._block_types);
+    }
+
+    Journal::message(Tags::App, "Reloaded {} files: {} textures, {} block types, {} chunks to remesh", std::size(files), std::size(textures),
+        std::size(blocks), std::size(chunks));
+}
+
+static auto process_events(const Configuration& conf, Application& app) {
     while (!app._events.empty()) {
-        // dispatch event
+        if (const auto event = std::get_if<Detail::ResourcesChangedEvent>(&app._events.front()); event) {
+            reload_resources(conf, app, event->files);
+        }
         app._events.pop();
     }
 }
 
+// Yaw and pitch as in recordings: yaw 0 looks down -z and pitch stops short of straight up or down
+static auto turn_camera(const Configuration& conf, Game::Camera& camera, const Input& input) -> void {
+    if (input.look_x == 0.0f && input.look_y == 0.0f) {
+        return;
+    }
+
+    const auto limit = glm::radians(89.0f);
+    const auto& direction = camera._direction;
+    const auto yaw = std::atan2(direction.x, -direction.z) + input.look_x * conf.mouse_sensitivity;
+    const auto pitch = std::clamp(std::asin(std::clamp(direction.y, -1.0f, 1.0f)) - input.look_y * conf.mouse_sensitivity, -limit, limit);
+
+    camera._direction = vec3 { std::sin(yaw) * std::cos(pitch), std::sin(pitch), -std::cos(yaw) * std::cos(pitch) };
+}
+
+static auto move_player(const Configuration& conf, Game::World& world, const Input& input, float dt) -> void {
+    auto& player = world._player;
+
+    // Walk in the horizontal plane regardless of where the camera is pitched
+    const auto flat = vec3 { world._camera._direction.x, 0.0f, world._camera._direction.z };
+    const auto forward = glm::length(flat) > 0.0f ? glm::normalize(flat) : vec3 { 0, 0, -1 };
+    const auto right = vec3 { -forward.z, 0.0f, forward.x };
+
+    auto heading = vec3 { 0, 0, 0 };
+    heading += input.forward ? forward : vec3 { 0 };
+    heading -= input.backward ? forward : vec3 { 0 };
+    heading += input.right ? right : vec3 { 0 };
+    heading -= input.left ? right : vec3 { 0 };
+
+    const auto horizontal = glm::length(heading) > 0.0f ? glm::normalize(heading) * conf.walk_speed : vec3 { 0 };
+
+    // Hold still until the ground under the player has streamed in, then fall; move_body
+    // zeroes the fall on landing and reports the contact as on_ground.
+    auto vertical = 0.0f;
+    const auto column = Game::world_to_chunk(ivec3 { glm::floor(player.position) });
+    if (Game::find_column(world, { column.x, column.z })) {
+        vertical = input.jump && player.on_ground ? conf.jump_speed : std::max(player.velocity.y - conf.gravity * dt, -conf.fall_speed);
+    }
+
+    player.velocity = vec3 { horizontal.x, vertical, horizontal.z };
+
+    Game::move_body(world, player, dt);
+    world._camera._position = player.position + vec3 { 0.0f, conf.eye_height, 0.0f };
+}
+
 static auto cleanup(Application& app) -> void {
+    if (app._watcher) {
+        destroy_file_watcher(app._watcher);
+    }
+
     destroy_window(app._window);
 
     glfwTerminate();
@@ -24,39 +164,226 @@ static auto cleanup(Application& app) -> void {
     Journal::message(Tags::App, "Shutdown");
 }
 
+// Everything a frame does to the world after the player moved, shared by the window loop and replays
+static auto step_world(Configuration& conf, Application& app, const Game::BlockTypes& block_types, const Input& input, float dt, double now,
+    float& tick_time) -> Game::StreamingStats {
+    if (input.button_left || input.button_right) {
+        app._world._target = Game::pick_block(app._world, conf.reach);
+    }
+
+    // Fixed rate ticks, at most a few per frame so a stall does not snowball
+    tick_time = std::min(tick_time + dt, 4.0f / conf.tick_rate);
+    while (tick_time >= 1.0f / conf.tick_rate) {
+        Game::update_world(app._world, block_types, conf.simulation);
+        tick_time -= 1.0f / conf.tick_rate;
+    }
+
+    Game::select_chunk_lods(app._world, Game::scale_lod_distances(conf.lod, app._lod_scale, conf.memory_budget.keep_radius));
+    const auto stats = Game::update_streaming(app._world, app._streamer, block_types, conf.streaming, now);
+
+    const auto actions = Game::enforce_memory_budget(
+        app._world, block_types, conf.memory_budget, conf.lod, app._lod_scale, conf.streaming.meshes_per_update);
+    if (actions.compacted > 0 || actions.downgraded > 0) {
+        Journal::warning(Tags::App, "Over memory budget, compacted {} chunks and coarsened {}", actions.compacted, actions.downgraded);
+    }
+    app._over_budget = actions.over;
+
+    return stats;
+}
+
+static auto place_player(const Configuration& conf, Game::World& world, const vec3& position) -> void {
+    world._player.position = position;
+    world._player.velocity = vec3 { 0 };
+    world._camera._position = position + vec3 { 0.0f, conf.eye_height, 0.0f };
+}
+
+// Drives the world loop from a recording or a scripted path without a window or a GPU
+static auto run_replay(Configuration& conf, Application& app) -> int {
+    const auto content = Content::read<std::string>(ResourcesFilepath);
+    if (!content) {
+        Journal::critical(Tags::App, "Failed to load blocks info from file='{}'!", ResourcesFilepath);
+        return EXIT_FAILURE;
+    }
+
+    const auto block_types = Game::get_block_types(*content);
+
+    // Replays neither load the player's saved columns nor write over them, so every run
+    // starts from the generated terrain
+    conf.streaming.save_directory.clear();
+
+    ReplayFrames frames;
+    if (const auto path = parse_replay_path(conf.replay); path) {
+        frames = make_replay_path(*path, conf.replay_frames, 1.0f / 60.0f);
+    } else if (auto recording = load_recording(conf.replay); recording) {
+        frames = std::move(*recording);
+    } else {
+        Journal::critical(Tags::App, "Failed to load replay '{}'!", conf.replay);
+        return EXIT_FAILURE;
+    }
+
+    Journal::message(Tags::App, "Replaying '{}', {} frames", conf.replay, std::size(frames));
+
+    place_player(conf, app._world, vec3 { 0.0f, static_cast<float>(Game::get_terrain_height({ 0, 0 })) + 2.0f, 0.0f });
+
+    std::vector<Game::Body> bodies(conf.replay_bodies);
+    spawn_bodies(bodies, app._world._player.position);
+
+    ReplayReport report;
+    std::vector<float> frame_times;
+    std::vector<float> body_times;
+    frame_times.reserve(std::size(frames));
+    body_times.reserve(std::size(frames));
+    auto tick_time = 0.0f;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (const auto& frame : frames) {
+        const auto begin = std::chrono::steady_clock::now();
+
+        // As in the live loop: the frame starts from its position, then the input moves the player
+        app._world._camera._direction = frame.direction;
+        if (frame.position) {
+            place_player(conf, app._world, *frame.position);
+        }
+        move_player(conf, app._world, frame.input, frame.dt);
+
+        // Latencies are wall clock, the world itself only advances by the recorded dt
+        const auto now = std::chrono::duration<double>(begin - start).count();
+        const auto stats = step_world(conf, app, block_types, frame.input, frame.dt, now, tick_time);
+
+        if (!bodies.empty()) {
+            const auto bodies_begin = std::chrono::steady_clock::now();
+            step_bodies(app._world, bodies, app._world._player.position, conf.gravity, frame.dt);
+            body_times.push_back(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - bodies_begin).count());
+        }
+
+        frame_times.push_back(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - begin).count());
+        report.columns_loaded += stats.loaded;
+        report.columns_unloaded += stats.unloaded;
+        report.backlog_peak = std::max(report.backlog_peak, stats.backlog);
+        report.backlog_end = stats.backlog;
+    }
+
+    std::vector<float> latencies;
+    for (const auto latency : app._streamer._latencies) {
+        latencies.push_back(latency * 1000.0f);
+    }
+
+    report.frames = std::size(frames);
+    report.frame_time = get_percentiles(std::move(frame_times));
+    report.load_latency = get_percentiles(std::move(latencies));
+    report.bodies = std::size(bodies);
+    report.body_time = get_percentiles(std::move(body_times));
+    report.lod = Game::get_lod_stats(app._world);
+
+    log_replay_report(report);
+    Memory::log_summary();
+
+    return EXIT_SUCCESS;
+}
+
 auto run(Configuration& conf, Application& app) -> int {
     Journal::message(Tags::App, "Start");
 
+    // Chunks expanded past the keep radius would be compacted again on the next frame while over budget
+    if (conf.streaming.expand_radius > conf.memory_budget.keep_radius) {
+        Journal::warning(
+            Tags::App, "Expand radius {} is past the keep radius, using {}", conf.streaming.expand_radius, conf.memory_budget.keep_radius);
+        conf.streaming.expand_radius = conf.memory_budget.keep_radius;
+    }
+
+    if (!conf.replay.empty()) {
+        return run_replay(conf, app);
+    }
+
     if (glfwInit() != GLFW_TRUE) {
         Journal::critical(Tags::App, "Initialization failed!");
         exit(EXIT_FAILURE);
     }
 
-    const auto block_info_filepath = "../assets/resources.json";
-
-    auto content = Content::read<std::string>(block_info_filepath);
+    auto content = Content::read<std::string>(ResourcesFilepath);
     if (!content) {
-        Journal::critical(Tags::App, "Failed to load blocks info from file='{}'!", block_info_filepath);
+        Journal::critical(Tags::App, "Failed to load blocks info from file='{}'!", ResourcesFilepath);
         exit(EXIT_FAILURE);
     }
 
     app._window = create_window({ .title = conf.title, .width = conf.window_width, .height = conf.window_height });
 
-    app._renderer
-        = Game::create_renderer({ .block_types = Game::get_block_types(*content), .texture_atlas = Graphics::get_texture_atlas(*content) });
+    auto texture_atlas = Graphics::get_texture_atlas(*content);
+    if (conf.compress_textures) {
+        Graphics::compress_texture_atlas(texture_atlas, conf.texture_compression);
+    }
+
+    app._renderer = Game::create_renderer({ .block_types = Game::get_block_types(*content),
+        .texture_atlas = texture_atlas,
+        .aspect = static_cast<float>(conf.window_width) / static_cast<float>(conf.window_height) });
+
+    place_player(conf, app._world, vec3 { 0.0f, static_cast<float>(Game::get_terrain_height({ 0, 0 })) + 2.0f, 0.0f });
+
+    const auto start = std::chrono::steady_clock::now();
+    auto last_frame = start;
+    auto tick_time = 0.0f;
+    auto report_time = 0.0f;
+
+    ReplayFrames recording;
+
+    if (conf.hot_reload) {
+        const std::string directories[] = { "../assets", "../assets/textures" };
+        app._watcher = create_file_watcher(directories);
+    }
 
     app._running = true;
     while (app._running) {
-        process_events(app);
+        if (std::vector<std::string> files; app._watcher && poll_file_changes(app._watcher, files)) {
+            app._events.push(Detail::ResourcesChangedEvent { std::move(files) });
+        }
+
+        process_events(conf, app);
 
         Input input;
         app._running = process_window_events(app._window, input);
 
-        Game::update_world(app._world);
+        const auto now = std::chrono::steady_clock::now();
+        const auto dt = std::chrono::duration<float>(now - last_frame).count();
+        last_frame = now;
+
+        turn_camera(conf, app._world._camera, input);
+
+        // Recorded before the step: the first frame keeps the position it starts from,
+        // walking from there is replayed from input
+        if (!conf.record_file.empty()) {
+            recording.push_back({ .dt = dt,
+                .input = input,
+                .direction = app._world._camera._direction,
+                .position = recording.empty() ? std::optional { app._world._player.position } : std::nullopt });
+        }
+
+        move_player(conf, app._world, input, dt);
+
+        step_world(conf, app, app._renderer._block_types, input, dt, std::chrono::duration<double>(now - start).count(), tick_time);
+
+        report_time += dt;
+        if (conf.memory_report_interval > 0.0f && report_time >= conf.memory_report_interval) {
+            Memory::log_summary();
+            for (uint32_t s = 0; s < static_cast<uint32_t>(Memory::Subsystem::Count); s++) {
+                if (app._over_budget & (1u << s)) {
+                    Journal::warning(Tags::App, "Memory of {} still over budget", Memory::get_subsystem_name(static_cast<Memory::Subsystem>(s)));
+                }
+            }
+            report_time = 0.0f;
+        }
 
         Game::present(app._renderer, app._world);
     }
 
+    if (const auto saved = Game::save_columns(app._world, conf.streaming); saved > 0) {
+        Journal::message(Tags::App, "Saved {} edited columns", saved);
+    }
+
+    if (!conf.record_file.empty() && !save_recording(conf.record_file, recording)) {
+        Journal::error(Tags::App, "Failed to write recording '{}'", conf.record_file);
+    }
+
     cleanup(app);
 
     return EXIT_SUCCESS;
@@ -11,6 +11,7 @@
 
 #include "Event.hpp"
 #include "Renderer.hpp"
+#include "Streaming.hpp"
 #include "World.hpp"
 
 namespace Application {
@@ -23,19 +24,46 @@ struct Configuration {
     bool vsync = false;
     bool window_centered = true;
     bool debug_graphics = true;
+    float reach = 8.0f;
+    float walk_speed = 4.3f;
+    float eye_height = 0.7f; // above the centre of the player's box
+    float gravity = 25.0f; // blocks per second squared
+    float fall_speed = 50.0f; // terminal
+    float jump_speed = 8.0f;
+    float mouse_sensitivity = 0.0025f; // radians per pixel of cursor movement
+    float tick_rate = 20.0f; // world simulation ticks per second
+    Game::SimulationSettings simulation;
+    bool compress_textures = true;
+    Graphics::CompressionSettings texture_compression;
+    bool hot_reload = true; // watch the assets and reload what changed
+    Game::StreamingSettings streaming;
+    // Follows streaming.view_distance, set it again after changing that. Scaled down at
+    // runtime while meshes exceed their budget.
+    Game::LodSettings lod = Game::get_lod_settings(streaming.view_distance);
+    Game::MemoryBudget memory_budget;
+    float memory_report_interval = 30.0f; // seconds between memory summaries, 0 disables them
+    std::string record_file; // the session's input is written there on exit
+    std::string replay; // recording file or scripted path (sprint, spiral, teleports), runs headless
+    size_t replay_frames = 3600; // length of scripted paths, at 60 frames per second
+    size_t replay_bodies = 500; // falling boxes stepped around the player during replays
 };
 
 using Threads = std::vector<std::jthread>;
 
 struct Window;
+struct FileWatcher;
 
 struct Application {
     Game::World _world;
     Game::Renderer _renderer;
+    Game::Streamer _streamer;
+    uint32_t _over_budget = 0; // Memory::Subsystem bits from the last enforce_memory_budget
+    float _lod_scale = 1.0f; // on conf.lod's distances, lowered and restored by enforce_memory_budget
 
     Threads _threads;
     EventQueue _events;
     std::shared_ptr<Window> _window;
+    std::shared_ptr<FileWatcher> _watcher;
     std::atomic_bool _running = false;
 };
 
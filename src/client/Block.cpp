@@ -3,33 +3,76 @@
 #include "Json.hpp"
 #include "Tags.hpp"
 
+#include <algorithm>
+#include <stdexcept>
+
 namespace Game {
 
+// at() throws on a missing field, operator[] on a const object does not check
+static auto get_face_color(const Json& face) -> vec3 {
+    const auto& color = face.at("color");
+    return vec3 { color.at(0), color.at(1), color.at(2) };
+}
+
+// Indices past the texture list would sample outside the atlas
+static auto get_face_texture(const Json& face, size_t texture_count) -> uint32_t {
+    const uint32_t texture = face.at("texture");
+    if (texture >= texture_count) {
+        throw std::out_of_range(fmt::format("texture {} is not in the list of {}", texture, texture_count));
+    }
+
+    return texture;
+}
+
+auto get_block_type(const BlockTypes& block_types, uint32_t block) -> const BlockType& {
+    static const BlockType missing = [] {
+        BlockType block_type;
+        const auto magenta = vec3 { 1.0f, 0.0f, 1.0f };
+        block_type.frontColor = block_type.leftColor = block_type.rightColor = magenta;
+        block_type.backColor = block_type.topColor = block_type.bottomColor = magenta;
+        return block_type;
+    }();
+
+    return block < std::size(block_types) ? block_types[block] : missing;
+}
+
 auto get_block_types(std::string_view info) -> BlockTypes {
     BlockTypes block_types;
 
     auto j = Json::parse(std::begin(info), std::end(info));
+    const auto texture_count = j.find("textures") != std::end(j) ? std::size(j["textures"]) : 0;
 
     if (j.find("block_types") != std::end(j)) {
         for (const auto& bt : j["block_types"]) {
             BlockType block_type;
-            block_type.frontTexture = bt["front"]["texture"];
-            block_type.frontColor = vec3 { bt["front"]["color"][0], bt["front"]["color"][1], bt["front"]["color"][2] };
+            block_type.frontTexture = get_face_texture(bt.at("front"), texture_count);
+            block_type.frontColor = get_face_color(bt.at("front"));
+
+            block_type.leftTexture = get_face_texture(bt.at("left"), texture_count);
+            block_type.leftColor = get_face_color(bt.at("left"));
+
+            block_type.rightTexture = get_face_texture(bt.at("right"), texture_count);
+            block_type.rightColor = get_face_color(bt.at("right"));
 
-            block_type.leftTexture = bt["left"]["texture"];
-            block_type.leftColor = vec3 { bt["left"]["color"][0], bt["left"]["color"][1], bt["left"]["color"][2] };
+            block_type.backTexture = get_face_texture(bt.at("back"), texture_count);
+            block_type.backColor = get_face_color(bt.at("back"));
 
-            block_type.rightTexture = bt["right"]["texture"];
-            block_type.rightColor = vec3 { bt["right"]["color"][0], bt["right"]["color"][1], bt["right"]["color"][2] };
+            block_type.topTexture = get_face_texture(bt.at("top"), texture_count);
+            block_type.topColor = get_face_color(bt.at("top"));
 
-            block_type.backTexture = bt["back"]["texture"];
-            block_type.backColor = vec3 { bt["back"]["color"][0], bt["back"]["color"][1], bt["back"]["color"][2] };
+            block_type.bottomTexture = get_face_texture(bt.at("bottom"), texture_count);
+            block_type.bottomColor = get_face_color(bt.at("bottom"));
 
-            block_type.topTexture = bt["top"]["texture"];
-            block_type.topColor = vec3 { bt["top"]["color"][0], bt["top"]["color"][1], bt["top"]["color"][2] };
+            block_type.light = value_or_default(bt, "light", 0u);
 
-            block_type.bottomTexture = bt["bottom"]["texture"];
-            block_type.bottomColor = vec3 { bt["bottom"]["color"][0], bt["bottom"]["color"][1], bt["bottom"]["color"][2] };
+            const auto behaviour = value_or_default(bt, "behaviour", std::string { "static" });
+            if (behaviour == "falling") {
+                block_type.behaviour = BlockBehaviour::Falling;
+            } else if (behaviour == "fluid") {
+                block_type.behaviour = BlockBehaviour::Fluid;
+            } else if (behaviour != "static") {
+                Journal::warning(Tags::Game, "Unknown block behaviour '{}'", behaviour);
+            }
 
             Journal::debug(Tags::Game, "Block {} {} {} {} {} {}", block_type.frontTexture, block_type.leftTexture, block_type.rightTexture,
                 block_type.backTexture, block_type.topTexture, block_type.bottomTexture);
@@ -45,4 +88,30 @@ auto get_block_types(std::string_view info) -> BlockTypes {
     return block_types;
 }
 
+auto diff_block_types(const BlockTypes& old_types, const BlockTypes& new_types) -> std::vector<uint32_t> {
+    std::vector<uint32_t> changed;
+
+    for (size_t id = 0; id < std::max(std::size(old_types), std::size(new_types)); id++) {
+        if (id >= std::size(old_types) || id >= std::size(new_types) || !(old_types[id] == new_types[id])) {
+            changed.push_back(static_cast<uint32_t>(id));
+        }
+    }
+
+    return changed;
+}
+
+auto get_blocks_using_texture(const BlockTypes& block_types, uint32_t texture) -> std::vector<uint32_t> {
+    std::vector<uint32_t> blocks;
+
+    for (size_t id = 0; id < std::size(block_types); id++) {
+        const auto& bt = block_types[id];
+        if (bt.frontTexture == texture || bt.leftTexture == texture || bt.rightTexture == texture || bt.backTexture == texture
+            || bt.topTexture == texture || bt.bottomTexture == texture) {
+            blocks.push_back(static_cast<uint32_t>(id));
+        }
+    }
+
+    return blocks;
+}
+
 } // namespace Game
\ No newline at end of file
@@ -7,6 +7,12 @@
 
 namespace Game {
 
+enum class BlockBehaviour : uint8_t {
+    Static,
+    Falling, // drops through air and fluids
+    Fluid, // flows down and spreads sideways from sources
+};
+
 struct BlockType {
     uint32_t frontTexture = 0;
     uint32_t leftTexture = 0;
@@ -21,6 +27,11 @@ struct BlockType {
     vec3 backColor = { 1.0f, 1.0f, 1.0f };
     vec3 topColor = { 1.0f, 1.0f, 1.0f };
     vec3 bottomColor = { 1.0f, 1.0f, 1.0f };
+
+    uint32_t light = 0;
+    BlockBehaviour behaviour = BlockBehaviour::Static;
+
+    auto operator==(const BlockType&) const -> bool = default;
 };
 
 using BlockTypes = std::vector<BlockType>;
@@ -38,6 +49,16 @@ static const std::vector<vec3> BlockTopFace
 static const std::vector<vec3> BlockBottomFace
     = { { -0.5f, -0.5f, 0.5f }, { 0.5f, -0.5f, 0.5f }, { 0.5f, -0.5f, -0.5f }, { -0.5f, -0.5f, -0.5f } };
 
+// Throws when a block type misses a face, texture or color, or uses a texture the list does not have.
 auto get_block_types(std::string_view info) -> BlockTypes;
 
+// Ids past the end of the table, left in the world after a reload removed their type,
+// get a plain magenta type so they stay visible without reading past the table.
+auto get_block_type(const BlockTypes& block_types, uint32_t block) -> const BlockType&;
+
+// Ids whose type differs between the two tables, including ids only one of them has.
+auto diff_block_types(const BlockTypes& old_types, const BlockTypes& new_types) -> std::vector<uint32_t>;
+
+auto get_blocks_using_texture(const BlockTypes& block_types, uint32_t texture) -> std::vector<uint32_t>;
+
 } // namespace Game
\ No newline at end of file
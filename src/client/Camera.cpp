@@ -1 +1,10 @@
 #include "Camera.hpp"
+
+namespace Game {
+
+auto update_camera(Camera& camera, float aspect) -> void {
+    camera._view = glm::lookAt(camera._position, camera._position + camera._direction, vec3 { 0.0f, 1.0f, 0.0f });
+    camera._projection = glm::perspective(glm::radians(camera._fov), aspect, camera._near, camera._far);
+}
+
+} // namespace Game
\ No newline at end of file
@@ -7,6 +7,14 @@ namespace Game {
 struct Camera {
     mat4 _projection;
     mat4 _view;
+    vec3 _position = vec3 { 0, 0, 0 };
+    vec3 _direction = vec3 { 0, 0, -1 };
+    float _fov = 70.0f; // vertical, in degrees
+    float _near = 0.1f;
+    float _far = 2048.0f;
 };
 
+// Rebuilds the view and projection from the position, direction and lens.
+auto update_camera(Camera& camera, float aspect) -> void;
+
 } // namespace Game
\ No newline at end of file
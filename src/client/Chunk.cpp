@@ -1,28 +1,146 @@
 #include "Chunk.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+
 namespace Game {
 
-auto create_chunk(const ivec2& position) -> Chunk {
+static auto push_face(Chunk& chunk, const std::vector<vec3>& face, const vec3& translation, const vec3& color, uint32_t texture) -> void {
+    chunk._vertices.push_back({ face[0] + translation, color, vec3(0.0f, 1.0f, texture) });
+    chunk._vertices.push_back({ face[1] + translation, color, vec3(1.0f, 1.0f, texture) });
+    chunk._vertices.push_back({ face[2] + translation, color, vec3(1.0f, 0.0f, texture) });
+    chunk._vertices.push_back({ face[3] + translation, color, vec3(0.0f, 0.0f, texture) });
+
+    chunk._indices.push_back(chunk._vertex_count);
+    chunk._indices.push_back(chunk._vertex_count + 1);
+    chunk._indices.push_back(chunk._vertex_count + 2);
+    chunk._indices.push_back(chunk._vertex_count + 2);
+    chunk._indices.push_back(chunk._vertex_count + 3);
+    chunk._indices.push_back(chunk._vertex_count);
+
+    chunk._vertex_count += 4;
+    chunk._index_count += 6;
+}
+
+struct ChunkMesher {
+    Chunk& chunk;
+    const BlockTypes& block_types;
+    const Chunk* above = nullptr;
+    const Chunk* below = nullptr;
+    const Chunk* left = nullptr;
+    const Chunk* right = nullptr;
+    const Chunk* front = nullptr;
+    const Chunk* back = nullptr;
+    bool buried = false;
+};
+
+// Faces are shaded by the light of the cell they face, in a neighbouring chunk when the
+// cell lies across the border. Cells of chunks that are not loaded count as open sky.
+static auto face_light(const ChunkMesher& mesher, size_t x, size_t y, size_t z, int32_t dx, int32_t dy, int32_t dz) -> vec3 {
+    constexpr auto size = static_cast<int32_t>(Chunk::Size);
+    const auto nx = static_cast<int32_t>(x) + dx;
+    const auto ny = static_cast<int32_t>(y) + dy;
+    const auto nz = static_cast<int32_t>(z) + dz;
+
+    // Only one of the offsets is ever non-zero
+    const Chunk* neighbour = &mesher.chunk;
+    if (nx < 0 || nx >= size) {
+        neighbour = nx < 0 ? mesher.left : mesher.right;
+    } else if (ny < 0 || ny >= size) {
+        neighbour = ny < 0 ? mesher.below : mesher.above;
+    } else if (nz < 0 || nz >= size) {
+        neighbour = nz < 0 ? mesher.front : mesher.back;
+    }
+
+    if (!neighbour) {
+        return vec3 { get_light_intensity(Chunk::MaxLight) };
+    }
+
+    const auto lx = (nx + size) % size;
+    const auto ly = (ny + size) % size;
+    const auto lz = (nz + size) % size;
+    return vec3 { get_light_intensity(std::max(get_sunlight(*neighbour, lx, ly, lz), get_blocklight(*neighbour, lx, ly, lz))) };
+}
+
+static auto build_block(ChunkMesher& mesher, size_t x, size_t y, size_t z) -> void {
+    auto& chunk = mesher.chunk;
+
+    const auto block_index = chunk._blocks[y][x][z];
+    if (block_index == 0) {
+        return;
+    }
+
+    const auto& block_type = get_block_type(mesher.block_types, block_index);
+    const auto translation = vec3 { x, y, z };
+
+    if (z == 0 || chunk._blocks[y][x][z - 1] == 0) {
+        const auto color = block_type.frontColor * face_light(mesher, x, y, z, 0, 0, -1);
+        push_face(chunk, BlockFrontFace, translation, color, block_type.frontTexture);
+    }
+
+    if (x == 0 || chunk._blocks[y][x - 1][z] == 0) {
+        const auto color = block_type.leftColor * face_light(mesher, x, y, z, -1, 0, 0);
+        push_face(chunk, BlockLeftFace, translation, color, block_type.leftTexture);
+    }
+
+    if (x == (Chunk::Size - 1) || chunk._blocks[y][x + 1][z] == 0) {
+        const auto color = block_type.rightColor * face_light(mesher, x, y, z, 1, 0, 0);
+        push_face(chunk, BlockRightFace, translation, color, block_type.rightTexture);
+    }
+
+    if (z == (Chunk::Size - 1) || chunk._blocks[y][x][z + 1] == 0) {
+        const auto color = block_type.backColor * face_light(mesher, x, y, z, 0, 0, 1);
+        push_face(chunk, BlockBackFace, translation, color, block_type.backTexture);
+    }
+
+    const auto top_open = y == (Chunk::Size - 1) ? (!mesher.above || mesher.above->_blocks[0][x][z] == 0) : chunk._blocks[y + 1][x][z] == 0;
+    if (top_open) {
+        const auto color = block_type.topColor * face_light(mesher, x, y, z, 0, 1, 0);
+        push_face(chunk, BlockTopFace, translation, color, block_type.topTexture);
+    }
+
+    const auto bottom_open = y == 0 ? (mesher.below ? mesher.below->_blocks[Chunk::Size - 1][x][z] == 0 : !mesher.buried) : chunk._blocks[y - 1][x][z] == 0;
+    if (bottom_open) {
+        const auto color = block_type.bottomColor * face_light(mesher, x, y, z, 0, -1, 0);
+        push_face(chunk, BlockBottomFace, translation, color, block_type.bottomTexture);
+    }
+}
+
+auto get_light_intensity(uint8_t level) -> float {
+    static const auto intensities = [] {
+        std::array<float, Chunk::MaxLight + 1> levels;
+        for (size_t i = 0; i < std::size(levels); i++) {
+            levels[i] = std::pow(0.8f, static_cast<float>(Chunk::MaxLight - i));
+        }
+        return levels;
+    }();
+
+    return intensities[std::min(level, Chunk::MaxLight)];
+}
+
+auto create_chunk(const ivec3& position) -> Chunk {
     Chunk chunk;
     chunk._position = position;
 
     auto model = glm::mat4 { 1.0f };
-    model = glm::translate(model, vec3(static_cast<float>(position.x * Chunk::Size), 0, static_cast<float>(position.y * Chunk::Size)));
+    model = glm::translate(model, vec3(position) * static_cast<float>(Chunk::Size));
 
     chunk._model = model;
 
-    for (size_t y = 0; y < Chunk::Size; y++) {
-        for (size_t x = 0; x < Chunk::Size; x++) {
-            for (size_t z = 0; z < Chunk::Size; z++) {
-                chunk._blocks[y][x][z] = 0;
-            }
-        }
-    }
+    // Every section starts out as uniform air, so a single fill is enough
+    std::fill_n(&chunk._blocks[0][0][0], Chunk::Size * Chunk::Size * Chunk::Size, 0u);
+    std::fill_n(&chunk._light[0][0][0], Chunk::Size * Chunk::Size * Chunk::Size, uint8_t { 0 });
 
     return chunk;
 }
 
-auto build_chunk(Chunk& chunk, const BlockTypes& block_types) -> void {
+auto build_chunk(Chunk& chunk, const BlockTypes& block_types, const ChunkNeighbours& neighbours) -> void {
+    ChunkMesher mesher { chunk, block_types, neighbours.above, neighbours.below, neighbours.left, neighbours.right, neighbours.front, neighbours.back,
+        neighbours.buried };
+    const auto above = neighbours.above;
+    const auto below = neighbours.below;
+    const auto buried = neighbours.buried;
 
     chunk._vertices.clear();
     chunk._indices.clear();
@@ -31,143 +149,145 @@ auto build_chunk(Chunk& chunk, const BlockTypes& block_types) -> void {
     chunk._vertex_count = 0;
     chunk._index_count = 0;
 
-    for (size_t y = 0; y < Chunk::Size; y++) {
-        for (size_t x = 0; x < Chunk::Size; x++) {
-            for (size_t z = 0; z < Chunk::Size; z++) {
-                const auto block_index = chunk._blocks[y][x][z];
-                if (block_index > 0) {
-                    const auto block_type = block_types[block_index];
-                    const auto translation = vec3 { x, y, z };
-
-                    if (z == 0 || chunk._blocks[y][x][z - 1] == 0) {
-                        chunk._vertices.push_back(
-                            { BlockFrontFace[0] + translation, block_type.frontColor, vec3(0.0f, 1.0f, block_type.frontTexture) });
-                        chunk._vertices.push_back(
-                            { BlockFrontFace[1] + translation, block_type.frontColor, vec3(1.0f, 1.0f, block_type.frontTexture) });
-                        chunk._vertices.push_back(
-                            { BlockFrontFace[2] + translation, block_type.frontColor, vec3(1.0f, 0.0f, block_type.frontTexture) });
-                        chunk._vertices.push_back(
-                            { BlockFrontFace[3] + translation, block_type.frontColor, vec3(0.0f, 0.0f, block_type.frontTexture) });
-
-                        chunk._indices.push_back(chunk._vertex_count);
-                        chunk._indices.push_back(chunk._vertex_count + 1);
-                        chunk._indices.push_back(chunk._vertex_count + 2);
-                        chunk._indices.push_back(chunk._vertex_count + 2);
-                        chunk._indices.push_back(chunk._vertex_count + 3);
-                        chunk._indices.push_back(chunk._vertex_count);
-
-                        chunk._vertex_count += 4;
-                        chunk._index_count += 6;
-                    }
+    for (size_t s = 0; s < Chunk::SectionCount; s++) {
+        const auto& section = chunk._sections[s];
+        if (is_section_empty(section)) {
+            continue;
+        }
 
-                    if (x == 0 || chunk._blocks[y][x - 1][z] == 0) {
-                        chunk._vertices.push_back(
-                            { BlockLeftFace[0] + translation, block_type.leftColor, vec3(0.0f, 1.0f, block_type.leftTexture) });
-                        chunk._vertices.push_back(
-                            { BlockLeftFace[1] + translation, block_type.leftColor, vec3(1.0f, 1.0f, block_type.leftTexture) });
-                        chunk._vertices.push_back(
-                            { BlockLeftFace[2] + translation, block_type.leftColor, vec3(1.0f, 0.0f, block_type.leftTexture) });
-                        chunk._vertices.push_back(
-                            { BlockLeftFace[3] + translation, block_type.leftColor, vec3(0.0f, 0.0f, block_type.leftTexture) });
-
-                        chunk._indices.push_back(chunk._vertex_count);
-                        chunk._indices.push_back(chunk._vertex_count + 1);
-                        chunk._indices.push_back(chunk._vertex_count + 2);
-                        chunk._indices.push_back(chunk._vertex_count + 2);
-                        chunk._indices.push_back(chunk._vertex_count + 3);
-                        chunk._indices.push_back(chunk._vertex_count);
-
-                        chunk._vertex_count += 4;
-                        chunk._index_count += 6;
-                    }
+        const auto y_begin = s * Chunk::SectionSize;
+        const auto y_end = y_begin + Chunk::SectionSize;
 
-                    if (x == (Chunk::Size - 1) || chunk._blocks[y][x + 1][z] == 0) {
-                        chunk._vertices.push_back(
-                            { BlockRightFace[0] + translation, block_type.rightColor, vec3(0.0f, 1.0f, block_type.rightTexture) });
-                        chunk._vertices.push_back(
-                            { BlockRightFace[1] + translation, block_type.rightColor, vec3(1.0f, 1.0f, block_type.rightTexture) });
-                        chunk._vertices.push_back(
-                            { BlockRightFace[2] + translation, block_type.rightColor, vec3(1.0f, 0.0f, block_type.rightTexture) });
-                        chunk._vertices.push_back(
-                            { BlockRightFace[3] + translation, block_type.rightColor, vec3(0.0f, 0.0f, block_type.rightTexture) });
-
-                        chunk._indices.push_back(chunk._vertex_count);
-                        chunk._indices.push_back(chunk._vertex_count + 1);
-                        chunk._indices.push_back(chunk._vertex_count + 2);
-                        chunk._indices.push_back(chunk._vertex_count + 2);
-                        chunk._indices.push_back(chunk._vertex_count + 3);
-                        chunk._indices.push_back(chunk._vertex_count);
-
-                        chunk._vertex_count += 4;
-                        chunk._index_count += 6;
+        if (!is_section_solid(section)) {
+            for (size_t y = y_begin; y < y_end; y++) {
+                for (size_t x = 0; x < Chunk::Size; x++) {
+                    for (size_t z = 0; z < Chunk::Size; z++) {
+                        build_block(mesher, x, y, z);
                     }
+                }
+            }
+            continue;
+        }
 
-                    if (z == (Chunk::Size - 1) || chunk._blocks[y][x][z + 1] == 0) {
-                        chunk._vertices.push_back(
-                            { BlockBackFace[0] + translation, block_type.backColor, vec3(0.0f, 1.0f, block_type.backTexture) });
-                        chunk._vertices.push_back(
-                            { BlockBackFace[1] + translation, block_type.backColor, vec3(1.0f, 1.0f, block_type.backTexture) });
-                        chunk._vertices.push_back(
-                            { BlockBackFace[2] + translation, block_type.backColor, vec3(1.0f, 0.0f, block_type.backTexture) });
-                        chunk._vertices.push_back(
-                            { BlockBackFace[3] + translation, block_type.backColor, vec3(0.0f, 0.0f, block_type.backTexture) });
-
-                        chunk._indices.push_back(chunk._vertex_count);
-                        chunk._indices.push_back(chunk._vertex_count + 1);
-                        chunk._indices.push_back(chunk._vertex_count + 2);
-                        chunk._indices.push_back(chunk._vertex_count + 2);
-                        chunk._indices.push_back(chunk._vertex_count + 3);
-                        chunk._indices.push_back(chunk._vertex_count);
-
-                        chunk._vertex_count += 4;
-                        chunk._index_count += 6;
-                    }
+        // Solid section: only the shell can have visible faces. The same visit
+        // order is kept so the mesh is identical to a full scan.
+        const auto section_below = s > 0 ? &chunk._sections[s - 1] : (below ? &below->_sections[Chunk::SectionCount - 1] : nullptr);
+        const auto section_above = s + 1 < Chunk::SectionCount ? &chunk._sections[s + 1] : (above ? &above->_sections[0] : nullptr);
+        const auto covered_below = section_below ? (section_below->_opaque_faces & ChunkSection::TopFace) != 0 : buried;
+        const auto covered_above = section_above && (section_above->_opaque_faces & ChunkSection::BottomFace) != 0;
 
-                    if (y == (Chunk::Size - 1) || chunk._blocks[y + 1][x][z] == 0) {
-                        chunk._vertices.push_back(
-                            { BlockTopFace[0] + translation, block_type.topColor, vec3(0.0f, 1.0f, block_type.topTexture) });
-                        chunk._vertices.push_back(
-                            { BlockTopFace[1] + translation, block_type.topColor, vec3(1.0f, 1.0f, block_type.topTexture) });
-                        chunk._vertices.push_back(
-                            { BlockTopFace[2] + translation, block_type.topColor, vec3(1.0f, 0.0f, block_type.topTexture) });
-                        chunk._vertices.push_back(
-                            { BlockTopFace[3] + translation, block_type.topColor, vec3(0.0f, 0.0f, block_type.topTexture) });
-
-                        chunk._indices.push_back(chunk._vertex_count);
-                        chunk._indices.push_back(chunk._vertex_count + 1);
-                        chunk._indices.push_back(chunk._vertex_count + 2);
-                        chunk._indices.push_back(chunk._vertex_count + 2);
-                        chunk._indices.push_back(chunk._vertex_count + 3);
-                        chunk._indices.push_back(chunk._vertex_count);
-
-                        chunk._vertex_count += 4;
-                        chunk._index_count += 6;
-                    }
+        for (size_t y = y_begin; y < y_end; y++) {
+            const auto layer_exposed = (y == y_begin && !covered_below) || (y == y_end - 1 && !covered_above);
 
-                    if (y == 0 || chunk._blocks[y - 1][x][z] == 0) {
-                        chunk._vertices.push_back(
-                            { BlockBottomFace[0] + translation, block_type.bottomColor, glm::vec3(0.0f, 1.0f, block_type.bottomTexture) });
-                        chunk._vertices.push_back(
-                            { BlockBottomFace[1] + translation, block_type.bottomColor, glm::vec3(1.0f, 1.0f, block_type.bottomTexture) });
-                        chunk._vertices.push_back(
-                            { BlockBottomFace[2] + translation, block_type.bottomColor, glm::vec3(1.0f, 0.0f, block_type.bottomTexture) });
-                        chunk._vertices.push_back(
-                            { BlockBottomFace[3] + translation, block_type.bottomColor, glm::vec3(0.0f, 0.0f, block_type.bottomTexture) });
-
-                        chunk._indices.push_back(chunk._vertex_count);
-                        chunk._indices.push_back(chunk._vertex_count + 1);
-                        chunk._indices.push_back(chunk._vertex_count + 2);
-                        chunk._indices.push_back(chunk._vertex_count + 2);
-                        chunk._indices.push_back(chunk._vertex_count + 3);
-                        chunk._indices.push_back(chunk._vertex_count);
-
-                        chunk._vertex_count += 4;
-                        chunk._index_count += 6;
+            for (size_t x = 0; x < Chunk::Size; x++) {
+                if (layer_exposed || x == 0 || x == (Chunk::Size - 1)) {
+                    for (size_t z = 0; z < Chunk::Size; z++) {
+                        build_block(mesher, x, y, z);
                     }
+                } else {
+                    build_block(mesher, x, y, 0);
+                    build_block(mesher, x, y, Chunk::Size - 1);
                 }
             }
         }
     }
+
+    chunk._dirty_sections = 0;
+}
+
+auto fill_chunk(Chunk& chunk, size_t y_begin, size_t y_end, uint32_t block) -> void {
+    y_end = std::min(y_end, Chunk::Size);
+    if (y_begin >= y_end) {
+        return;
+    }
+
+    std::fill_n(&chunk._blocks[y_begin][0][0], (y_end - y_begin) * Chunk::Size * Chunk::Size, block);
+
+    for (size_t s = y_begin / Chunk::SectionSize; s * Chunk::SectionSize < y_end; s++) {
+        const auto section_begin = s * Chunk::SectionSize;
+        const auto section_end = section_begin + Chunk::SectionSize;
+
+        if (y_begin <= section_begin && section_end <= y_end) {
+            auto& section = chunk._sections[s];
+            section._block = block;
+            section._uniform = true;
+            section._solid_count = block != 0 ? Chunk::SectionVolume : 0;
+            section._opaque_faces = block != 0 ? ChunkSection::AllFaces : 0;
+        } else {
+            update_chunk_section(chunk, s);
+        }
+    }
+}
+
+auto update_chunk_section(Chunk& chunk, size_t s) -> void {
+    constexpr size_t LayerArea = Chunk::Size * Chunk::Size;
+    constexpr size_t SideArea = Chunk::Size * Chunk::SectionSize;
+
+    const auto y_begin = s * Chunk::SectionSize;
+    const auto y_end = y_begin + Chunk::SectionSize;
+    const auto first = chunk._blocks[y_begin][0][0];
+
+    bool uniform = true;
+    size_t solid_count = 0;
+    size_t front = 0, left = 0, right = 0, back = 0, top = 0, bottom = 0;
+
+    for (size_t y = y_begin; y < y_end; y++) {
+        for (size_t x = 0; x < Chunk::Size; x++) {
+            for (size_t z = 0; z < Chunk::Size; z++) {
+                const auto block = chunk._blocks[y][x][z];
+                uniform &= block == first;
+                if (block == 0) {
+                    continue;
+                }
+
+                solid_count++;
+                front += z == 0;
+                left += x == 0;
+                right += x == (Chunk::Size - 1);
+                back += z == (Chunk::Size - 1);
+                top += y == (y_end - 1);
+                bottom += y == y_begin;
+            }
+        }
+    }
+
+    uint8_t faces = 0;
+    faces |= front == SideArea ? ChunkSection::FrontFace : 0;
+    faces |= left == SideArea ? ChunkSection::LeftFace : 0;
+    faces |= right == SideArea ? ChunkSection::RightFace : 0;
+    faces |= back == SideArea ? ChunkSection::BackFace : 0;
+    faces |= top == LayerArea ? ChunkSection::TopFace : 0;
+    faces |= bottom == LayerArea ? ChunkSection::BottomFace : 0;
+
+    auto& section = chunk._sections[s];
+    section._block = uniform ? first : 0;
+    section._uniform = uniform;
+    section._solid_count = static_cast<uint32_t>(solid_count);
+    section._opaque_faces = faces;
+}
+
+auto update_chunk_sections(Chunk& chunk) -> void {
+    for (size_t s = 0; s < Chunk::SectionCount; s++) {
+        update_chunk_section(chunk, s);
+    }
+}
+
+auto get_chunk_extent(const Chunk& chunk) -> std::pair<size_t, size_t> {
+    size_t first = Chunk::SectionCount;
+    size_t last = 0;
+
+    for (size_t s = 0; s < Chunk::SectionCount; s++) {
+        if (!is_section_empty(chunk._sections[s])) {
+            first = std::min(first, s);
+            last = s + 1;
+        }
+    }
+
+    if (first == Chunk::SectionCount) {
+        return { 0, 0 };
+    }
+
+    return { first * Chunk::SectionSize, last * Chunk::SectionSize };
 }
 
 } // namespace Game
\ No newline at end of file
@@ -2,22 +2,64 @@
 
 #include "Block.hpp"
 #include "Math.hpp"
+#include "Memory.hpp"
 #include "Vertex.hpp"
 
+#include <utility>
 #include <vector>
 
 namespace Game {
 
+// Summary of a horizontal slab of a chunk, kept in sync with the voxels so
+// generation, meshing and storage can skip all-air or all-solid slabs.
+struct ChunkSection {
+    static constexpr uint8_t FrontFace = 1 << 0;
+    static constexpr uint8_t LeftFace = 1 << 1;
+    static constexpr uint8_t RightFace = 1 << 2;
+    static constexpr uint8_t BackFace = 1 << 3;
+    static constexpr uint8_t TopFace = 1 << 4;
+    static constexpr uint8_t BottomFace = 1 << 5;
+    static constexpr uint8_t AllFaces = 0x3f;
+
+    uint32_t _block = 0;
+    uint32_t _solid_count = 0;
+    bool _uniform = true;
+    uint8_t _opaque_faces = 0;
+};
+
+struct Chunk;
+
+// Loaded chunks around the one being meshed, their border cells shade its border faces.
+struct ChunkNeighbours {
+    const Chunk* above = nullptr;
+    const Chunk* below = nullptr;
+    const Chunk* left = nullptr; // x - 1
+    const Chunk* right = nullptr; // x + 1
+    const Chunk* front = nullptr; // z - 1
+    const Chunk* back = nullptr; // z + 1
+    bool buried = false; // nothing is loaded below but the column's implicit fill is solid there
+};
+
 struct Chunk {
-    using Vertices = std::vector<Vertex>;
-    using Indices = std::vector<uint32_t>;
+    using Vertices = std::vector<Vertex, Memory::TrackedAllocator<Vertex, Memory::Subsystem::Meshes>>;
+    using Indices = std::vector<uint32_t, Memory::TrackedAllocator<uint32_t, Memory::Subsystem::Meshes>>;
 
     static constexpr size_t Size = 64;
+    static constexpr size_t SectionSize = 16;
+    static constexpr size_t SectionCount = Size / SectionSize;
+    static constexpr size_t SectionVolume = SectionSize * Size * Size;
+    static constexpr uint8_t MaxLight = 15;
+    static constexpr uint32_t LodCount = 4; // 1x, 2x, 4x and 8x voxels per mesh cell
 
-    ivec2 _position = ivec2 { 0, 0 };
+    ivec3 _position = ivec3 { 0, 0, 0 }; // in chunks, chunks stack vertically
     mat4 _model;
+    uint32_t _lod = 0;
 
     uint32_t _blocks[Size][Size][Size];
+    uint8_t _light[Size][Size][Size]; // sunlight in the high nibble, block light in the low one
+    ChunkSection _sections[SectionCount];
+    uint8_t _dirty_sections = 0; // sections whose mesh is out of date
+    uint8_t _unsaved_sections = 0; // sections edited since the last save_chunk
 
     size_t _vertex_count = 0;
     size_t _index_count = 0;
@@ -26,7 +68,47 @@ struct Chunk {
     Indices _indices;
 };
 
-auto create_chunk(const ivec2& position) -> Chunk;
-auto build_chunk(Chunk& chunk, const BlockTypes& block_types) -> void;
+inline auto is_section_empty(const ChunkSection& section) -> bool {
+    return section._solid_count == 0;
+}
+
+inline auto is_section_solid(const ChunkSection& section) -> bool {
+    return section._solid_count == Chunk::SectionVolume;
+}
+
+inline auto get_sunlight(const Chunk& chunk, size_t x, size_t y, size_t z) -> uint8_t {
+    return chunk._light[y][x][z] >> 4;
+}
+
+inline auto get_blocklight(const Chunk& chunk, size_t x, size_t y, size_t z) -> uint8_t {
+    return chunk._light[y][x][z] & 0xf;
+}
+
+inline auto set_sunlight(Chunk& chunk, size_t x, size_t y, size_t z, uint8_t level) -> void {
+    chunk._light[y][x][z] = static_cast<uint8_t>((chunk._light[y][x][z] & 0xf) | (level << 4));
+}
+
+inline auto set_blocklight(Chunk& chunk, size_t x, size_t y, size_t z, uint8_t level) -> void {
+    chunk._light[y][x][z] = static_cast<uint8_t>((chunk._light[y][x][z] & 0xf0) | level);
+}
+
+// Brightness factor applied to vertex colours for a light level
+auto get_light_intensity(uint8_t level) -> float;
+
+auto create_chunk(const ivec3& position) -> Chunk;
+
+// The vertical neighbours also cull the top and bottom faces. Faces looking into a
+// chunk that is not loaded are fully lit.
+auto build_chunk(Chunk& chunk, const BlockTypes& block_types, const ChunkNeighbours& neighbours = {}) -> void;
+
+// Writes block into layers [y_begin, y_end); whole sections are summarised without a rescan.
+auto fill_chunk(Chunk& chunk, size_t y_begin, size_t y_end, uint32_t block) -> void;
+
+// Must be called after writing _blocks directly.
+auto update_chunk_section(Chunk& chunk, size_t section) -> void;
+auto update_chunk_sections(Chunk& chunk) -> void;
+
+// Returns [y_begin, y_end) covering the non-empty sections, used to tighten culling bounds.
+auto get_chunk_extent(const Chunk& chunk) -> std::pair<size_t, size_t>;
 
 } // namespace Game
\ No newline at end of file
@@ -0,0 +1,191 @@
+#include "Collision.hpp"
+#include "World.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Game {
+
+// Gap left between a stopped body and the face it ran into, so the next sweep
+// does not start overlapping it due to rounding.
+static constexpr float Skin = 1.0f / 1024.0f;
+
+struct CollisionCursor {
+    const Chunk* chunk = nullptr;
+    ivec3 chunk_position = ivec3 { 0, 0, 0 };
+    bool cached = false;
+};
+
+static auto lookup(const World& world, CollisionCursor& cursor, const ivec3& chunk_position) -> const Chunk* {
+    if (!cursor.cached || cursor.chunk_position != chunk_position) {
+        cursor.chunk = find_chunk(world, chunk_position);
+        cursor.chunk_position = chunk_position;
+        cursor.cached = true;
+    }
+
+    return cursor.chunk;
+}
+
+// Any solid block in the cell box [lo, hi], bounds inclusive. Empty sections are
+// skipped and fully solid ones answer without touching the voxels.
+static auto is_region_solid(const World& world, CollisionCursor& cursor, const ivec3& lo, const ivec3& hi) -> bool {
+    constexpr auto size = static_cast<int32_t>(Chunk::Size);
+    constexpr auto section_size = static_cast<int32_t>(Chunk::SectionSize);
+
+    const auto first = world_to_chunk(lo);
+    const auto last = world_to_chunk(hi);
+
+    for (auto cy = first.y; cy <= last.y; cy++) {
+        for (auto cx = first.x; cx <= last.x; cx++) {
+            for (auto cz = first.z; cz <= last.z; cz++) {
+                const auto chunk_position = ivec3 { cx, cy, cz };
+                const auto origin = chunk_origin(chunk_position);
+                const auto a = glm::max(lo, origin) - origin;
+                const auto b = glm::min(hi, origin + ivec3 { size - 1 }) - origin;
+
+                if (const auto chunk = lookup(world, cursor, chunk_position); chunk) {
+                    for (auto s = a.y / section_size; s <= b.y / section_size; s++) {
+                        const auto& section = chunk->_sections[s];
+                        if (is_section_empty(section)) {
+                            continue;
+                        }
+                        if (is_section_solid(section)) {
+                            return true;
+                        }
+
+                        const auto y_end = std::min(b.y, s * section_size + section_size - 1);
+                        for (auto y = std::max(a.y, s * section_size); y <= y_end; y++) {
+                            for (auto x = a.x; x <= b.x; x++) {
+                                for (auto z = a.z; z <= b.z; z++) {
+                                    if (chunk->_blocks[y][x][z] != 0) {
+                                        return true;
+                                    }
+                                }
+                            }
+                        }
+                    }
+                    continue;
+                }
+
+                if (const auto it = world._far_chunks.find(chunk_key(chunk_position)); it != std::end(world._far_chunks)) {
+                    if (!is_region_empty(it->second, a, b + ivec3 { 1 })) {
+                        return true;
+                    }
+                    continue;
+                }
+
+                if (get_implicit_block(world, chunk_position) != 0) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+// Cells overlapped by the open interval (lo, hi) along one axis
+static auto first_cell(float lo) -> int32_t {
+    return static_cast<int32_t>(std::floor(lo + 0.5f));
+}
+
+static auto last_cell(float hi) -> int32_t {
+    return static_cast<int32_t>(std::ceil(hi + 0.5f)) - 1;
+}
+
+// Largest part of the displacement d along axis a the box can travel before a
+// solid layer of cells stops it. Layers are visited nearest first.
+static auto sweep_axis(const World& world, CollisionCursor& cursor, const Aabb& box, int32_t a, float d) -> float {
+    if (d == 0.0f) {
+        return 0.0f;
+    }
+
+    ivec3 lo;
+    ivec3 hi;
+    for (int32_t i = 0; i < 3; i++) {
+        lo[i] = first_cell(box.min[i]);
+        hi[i] = last_cell(box.max[i]);
+    }
+
+    if (d > 0.0f) {
+        const auto begin = static_cast<int32_t>(std::ceil(box.max[a] + 0.5f - Skin));
+        const auto end = last_cell(box.max[a] + d);
+        for (auto c = begin; c <= end; c++) {
+            lo[a] = c;
+            hi[a] = c;
+            if (is_region_solid(world, cursor, lo, hi)) {
+                return std::clamp(static_cast<float>(c) - 0.5f - box.max[a] - Skin, 0.0f, d);
+            }
+        }
+    } else {
+        const auto begin = static_cast<int32_t>(std::floor(box.min[a] - 0.5f + Skin));
+        const auto end = first_cell(box.min[a] + d);
+        for (auto c = begin; c >= end; c--) {
+            lo[a] = c;
+            hi[a] = c;
+            if (is_region_solid(world, cursor, lo, hi)) {
+                return std::clamp(static_cast<float>(c) + 0.5f - box.min[a] + Skin, d, 0.0f);
+            }
+        }
+    }
+
+    return d;
+}
+
+static auto step_body(const World& world, CollisionCursor& cursor, Body& body, float dt) -> bool {
+    constexpr int32_t order[] = { 1, 0, 2 };
+
+    const auto displacement = body.velocity * dt;
+
+    body.contacts = ivec3 { 0, 0, 0 };
+    body.on_ground = false;
+
+    for (const auto a : order) {
+        const auto d = displacement[a];
+        const auto moved = sweep_axis(world, cursor, get_aabb(body), a, d);
+        body.position[a] += moved;
+
+        if (moved != d) {
+            body.contacts[a] = d > 0.0f ? 1 : -1;
+            body.velocity[a] = 0.0f;
+        }
+    }
+
+    body.on_ground = body.contacts.y < 0;
+
+    return body.contacts != ivec3 { 0, 0, 0 };
+}
+
+auto is_colliding(const World& world, const Aabb& box) -> bool {
+    CollisionCursor cursor;
+
+    ivec3 lo;
+    ivec3 hi;
+    for (int32_t i = 0; i < 3; i++) {
+        lo[i] = first_cell(box.min[i]);
+        hi[i] = last_cell(box.max[i]);
+        if (hi[i] < lo[i]) {
+            return false;
+        }
+    }
+
+    return is_region_solid(world, cursor, lo, hi);
+}
+
+auto move_body(const World& world, Body& body, float dt) -> void {
+    CollisionCursor cursor;
+    step_body(world, cursor, body, dt);
+}
+
+auto move_bodies(const World& world, std::span<Body> bodies, float dt) -> size_t {
+    CollisionCursor cursor;
+    size_t blocked = 0;
+
+    for (auto& body : bodies) {
+        blocked += step_body(world, cursor, body, dt) ? 1 : 0;
+    }
+
+    return blocked;
+}
+
+} // namespace Game
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Math.hpp"
+
+#include <span>
+
+namespace Game {
+
+struct World;
+
+// Every non-air block is a unit cube centred on its integer position, the same
+// convention the renderer and raycasts use.
+struct Aabb {
+    vec3 min = vec3 { 0, 0, 0 };
+    vec3 max = vec3 { 0, 0, 0 };
+};
+
+struct Body {
+    vec3 position = vec3 { 0, 0, 0 }; // centre of the box
+    vec3 half_extents = vec3 { 0.3f, 0.9f, 0.3f };
+    vec3 velocity = vec3 { 0, 0, 0 };
+    ivec3 contacts = ivec3 { 0, 0, 0 }; // per axis, the direction the last move was blocked in
+    bool on_ground = false;
+};
+
+inline auto get_aabb(const Body& body) -> Aabb {
+    return { body.position - body.half_extents, body.position + body.half_extents };
+}
+
+// True when the box overlaps a solid block. Touching faces do not count.
+auto is_colliding(const World& world, const Aabb& box) -> bool;
+
+// Sweeps the body by velocity * dt one axis at a time (y, x, z) and stops it flush
+// against the first solid layer on each axis; the blocked velocity components are
+// zeroed. A body that starts inside blocks is only stopped by layers ahead of it.
+auto move_body(const World& world, Body& body, float dt) -> void;
+
+// Steps many bodies with one chunk lookup cache; returns how many were blocked.
+auto move_bodies(const World& world, std::span<Body> bodies, float dt) -> size_t;
+
+} // namespace Game
\ No newline at end of file
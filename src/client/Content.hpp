@@ -1,11 +1,40 @@
 #pragma once
 
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <optional>
+#include <span>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 namespace Content {
 
+using ByteBuffer = std::vector<uint8_t>;
+
+// Values are stored as their bytes in memory, files are read back on machines of the same byte order.
+template <typename T> inline auto write_value(ByteBuffer& buf, const T& value) -> void {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    const auto offset = std::size(buf);
+    buf.resize(offset + sizeof(T));
+    memcpy(std::data(buf) + offset, &value, sizeof(T));
+}
+
+// Moves data past the value, or returns false when it is too short to hold one.
+template <typename T> inline auto read_value(std::span<const uint8_t>& data, T& value) -> bool {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    if (std::size(data) < sizeof(T)) {
+        return false;
+    }
+
+    memcpy(&value, std::data(data), sizeof(T));
+    data = data.subspan(sizeof(T));
+    return true;
+}
+
 template <typename Buffer> inline auto read(std::string_view filepath) -> std::optional<Buffer> {
     using namespace std;
 
@@ -26,7 +55,7 @@ template <typename Buffer> inline auto read(std::string_view filepath) -> std::o
 }
 
 inline auto write(std::string_view path, std::string_view buf) -> bool {
-    std::ofstream fs(path.data());
+    std::ofstream fs(path.data(), std::ios::out | std::ios::binary);
     if (!fs.is_open()) {
         return false;
     }
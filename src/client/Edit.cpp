@@ -0,0 +1,168 @@
+#include "Edit.hpp"
+#include "Lighting.hpp"
+#include "Simulation.hpp"
+#include "World.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+namespace Game {
+
+// Sections whose faces can change when a block in layer y does
+static auto get_affected_sections(size_t y) -> uint8_t {
+    const auto s = y / Chunk::SectionSize;
+    auto sections = 1u << s;
+    if (y % Chunk::SectionSize == 0 && s > 0) {
+        sections |= 1u << (s - 1);
+    }
+    if (y % Chunk::SectionSize == Chunk::SectionSize - 1 && s + 1 < Chunk::SectionCount) {
+        sections |= 1u << (s + 1);
+    }
+
+    return static_cast<uint8_t>(sections);
+}
+
+// Top and bottom faces of the vertical neighbours change when a border layer does
+static auto mark_vertical_neighbours(World& world, const ivec3& chunk_position, uint8_t layers) -> void {
+    if (layers & 1u) {
+        if (auto below = find_chunk(world, chunk_position - ivec3 { 0, 1, 0 })) {
+            below->_dirty_sections |= static_cast<uint8_t>(1u << (Chunk::SectionCount - 1));
+        }
+    }
+    if (layers & 2u) {
+        if (auto above = find_chunk(world, chunk_position + ivec3 { 0, 1, 0 })) {
+            above->_dirty_sections |= 1u;
+        }
+    }
+}
+
+static auto flush_chunk(World& world, Chunk* chunk, uint8_t written, uint8_t dirty, uint8_t borders) -> void {
+    if (!chunk || written == 0) {
+        return;
+    }
+
+    mark_vertical_neighbours(world, chunk->_position, borders);
+
+    for (size_t s = 0; s < Chunk::SectionCount; s++) {
+        if (written & (1u << s)) {
+            update_chunk_section(*chunk, s);
+        }
+    }
+
+    chunk->_dirty_sections |= dirty;
+    chunk->_unsaved_sections |= written;
+}
+
+auto apply_edits(World& world, const BlockTypes& block_types, std::span<const BlockEdit> edits, ChangeJournal* journal) -> size_t {
+    // Group by chunk, keeping submission order within a chunk so later edits win
+    std::vector<uint32_t> order(std::size(edits));
+    std::iota(std::begin(order), std::end(order), 0u);
+    std::stable_sort(std::begin(order), std::end(order), [&edits](uint32_t a, uint32_t b) {
+        return chunk_key(world_to_chunk(edits[a].position)) < chunk_key(world_to_chunk(edits[b].position));
+    });
+
+    ChangeJournal changes;
+    changes.reserve(std::size(edits));
+
+    Chunk* chunk = nullptr;
+    auto chunk_position = ivec3 { 0, 0, 0 };
+    uint8_t written = 0;
+    uint8_t dirty = 0;
+    uint8_t borders = 0;
+
+    for (const auto i : order) {
+        const auto& edit = edits[i];
+        const auto position = world_to_chunk(edit.position);
+        if (!chunk || position != chunk_position) {
+            flush_chunk(world, chunk, written, dirty, borders);
+            chunk = find_chunk(world, position);
+            chunk_position = position;
+
+            // Edits above the loaded chunks or into the implicit fill below them get a chunk
+            if (!chunk) {
+                for (const auto& added : allocate_chunk(world, position)) {
+                    auto& created = *find_chunk(world, added);
+                    light_chunk(world, created, block_types);
+                    schedule_chunk(world._simulation, created, block_types);
+                }
+                chunk = find_chunk(world, position);
+            }
+            written = 0;
+            dirty = 0;
+            borders = 0;
+        }
+
+        if (!chunk) {
+            continue;
+        }
+
+        const auto local = world_to_local(edit.position);
+        auto& block = chunk->_blocks[local.y][local.x][local.z];
+        if (block == edit.block) {
+            continue;
+        }
+
+        changes.push_back({ .position = edit.position, .old_block = block, .new_block = edit.block });
+        block = edit.block;
+
+        written |= static_cast<uint8_t>(1u << (local.y / Chunk::SectionSize));
+        dirty |= get_affected_sections(static_cast<size_t>(local.y));
+        borders |= local.y == 0 ? 1u : (local.y == Chunk::Size - 1 ? 2u : 0u);
+    }
+
+    flush_chunk(world, chunk, written, dirty, borders);
+
+    update_light(world, block_types, changes);
+    schedule_changes(world._simulation, changes);
+
+    if (journal) {
+        journal->insert(std::end(*journal), std::begin(changes), std::end(changes));
+    }
+
+    return std::size(changes);
+}
+
+auto replay_changes(World& world, const BlockTypes& block_types, std::span<const BlockChange> changes) -> size_t {
+    std::vector<BlockEdit> edits;
+    edits.reserve(std::size(changes));
+
+    for (const auto& change : changes) {
+        edits.push_back({ .position = change.position, .block = change.new_block });
+    }
+
+    return apply_edits(world, block_types, edits);
+}
+
+auto revert_changes(World& world, const BlockTypes& block_types, std::span<const BlockChange> changes) -> size_t {
+    std::vector<BlockEdit> edits;
+    edits.reserve(std::size(changes));
+
+    for (auto it = std::rbegin(changes); it != std::rend(changes); ++it) {
+        edits.push_back({ .position = it->position, .block = it->old_block });
+    }
+
+    return apply_edits(world, block_types, edits);
+}
+
+auto squash_changes(std::span<const BlockChange> changes) -> ChangeJournal {
+    std::unordered_map<uint64_t, size_t> index;
+    ChangeJournal squashed;
+
+    for (const auto& change : changes) {
+        const auto cell = block_key(change.position);
+        if (const auto it = index.find(cell); it != std::end(index)) {
+            squashed[it->second].new_block = change.new_block;
+            continue;
+        }
+
+        index.emplace(cell, std::size(squashed));
+        squashed.push_back(change);
+    }
+
+    std::erase_if(squashed, [](const auto& change) { return change.old_block == change.new_block; });
+
+    return squashed;
+}
+
+} // namespace Game
\ No newline at end of file
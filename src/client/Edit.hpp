@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Block.hpp"
+#include "Math.hpp"
+
+#include <span>
+#include <vector>
+
+namespace Game {
+
+struct World;
+
+struct BlockEdit {
+    ivec3 position = ivec3 { 0, 0, 0 };
+    uint32_t block = 0;
+};
+
+struct BlockChange {
+    ivec3 position = ivec3 { 0, 0, 0 };
+    uint32_t old_block = 0;
+    uint32_t new_block = 0;
+};
+
+using ChangeJournal = std::vector<BlockChange>;
+
+// Applies edits in world coordinates grouped by chunk: each touched section is
+// summarised once, lighting is updated in a single pass, and affected sections
+// are flagged for remeshing and saving. Later edits of the same block win.
+// Chunks missing in a loaded column are allocated, edits into columns that are
+// not loaded are dropped. The changed blocks wake the world's simulation. Returns
+// the number of blocks that actually changed; these are appended to journal when one is given.
+auto apply_edits(World& world, const BlockTypes& block_types, std::span<const BlockEdit> edits, ChangeJournal* journal = nullptr) -> size_t;
+
+auto replay_changes(World& world, const BlockTypes& block_types, std::span<const BlockChange> changes) -> size_t;
+auto revert_changes(World& world, const BlockTypes& block_types, std::span<const BlockChange> changes) -> size_t;
+
+// Collapses a journal into its net effect: one entry per block, no-op entries dropped.
+auto squash_changes(std::span<const BlockChange> changes) -> ChangeJournal;
+
+} // namespace Game
\ No newline at end of file
@@ -3,16 +3,20 @@
 #include <queue>
 #include <string>
 #include <variant>
+#include <vector>
 
 namespace Application {
 namespace Detail {
 
     struct QuitEvent { };
     struct StartUpEvent { };
+    struct ResourcesChangedEvent {
+        std::vector<std::string> files;
+    };
 
 } // namespace Detail
 
-using Event = std::variant<Detail::StartUpEvent, Detail::QuitEvent>;
+using Event = std::variant<Detail::StartUpEvent, Detail::QuitEvent, Detail::ResourcesChangedEvent>;
 using EventQueue = std::queue<Event>;
 
 } // namespace Application
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "FileWatcher.hpp"
+#include "Journal.hpp"
+#include "Tags.hpp"
+
+#include <algorithm>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace Application {
+
+auto create_file_watcher(std::span<const std::string> directories) -> std::shared_ptr<FileWatcher> {
+    FileWatcher watcher;
+
+#if defined(__linux__)
+    watcher.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watcher.fd < 0) {
+        Journal::warning(Tags::App, "{}", "File watching unavailable, hot reload disabled");
+        return std::make_shared<FileWatcher>(watcher);
+    }
+
+    for (const auto& directory : directories) {
+        // Editors often save through a temporary file that is renamed over the original
+        const auto wd = inotify_add_watch(watcher.fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd < 0) {
+            Journal::warning(Tags::App, "Failed to watch '{}'", directory);
+            continue;
+        }
+
+        watcher.directories.emplace(wd, directory);
+    }
+#else
+    Journal::message(Tags::App, "{}", "File watching is only supported on Linux");
+    (void)directories;
+#endif
+
+    return std::make_shared<FileWatcher>(watcher);
+}
+
+auto destroy_file_watcher(std::shared_ptr<FileWatcher> watcher) -> void {
+#if defined(__linux__)
+    if (watcher && watcher->fd >= 0) {
+        close(watcher->fd);
+        watcher->fd = -1;
+    }
+#else
+    (void)watcher;
+#endif
+}
+
+auto poll_file_changes(std::shared_ptr<FileWatcher> watcher, std::vector<std::string>& files) -> bool {
+    const auto count = std::size(files);
+
+#if defined(__linux__)
+    if (!watcher || watcher->fd < 0) {
+        return false;
+    }
+
+    alignas(inotify_event) char buffer[4096];
+    for (;;) {
+        const auto length = read(watcher->fd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;
+        }
+
+        for (ssize_t offset = 0; offset < length;) {
+            const auto event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            const auto it = watcher->directories.find(event->wd);
+            if (it == std::end(watcher->directories) || event->len == 0) {
+                continue;
+            }
+
+            auto file = it->second + "/" + event->name;
+            if (std::find(std::begin(files) + static_cast<std::ptrdiff_t>(count), std::end(files), file) == std::end(files)) {
+                files.push_back(std::move(file));
+            }
+        }
+    }
+#else
+    (void)watcher;
+#endif
+
+    return std::size(files) != count;
+}
+
+} // namespace Application
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Application {
+
+struct FileWatcher {
+    int fd = -1;
+    std::unordered_map<int, std::string> directories; // watch descriptor to watched path
+};
+
+// Watches the directories, not recursively, for files that were written or moved
+// in. Without inotify the watcher is created but never reports anything.
+auto create_file_watcher(std::span<const std::string> directories) -> std::shared_ptr<FileWatcher>;
+auto destroy_file_watcher(std::shared_ptr<FileWatcher> watcher) -> void;
+
+// Never blocks. Appends "<directory>/<file>" once per changed file.
+auto poll_file_changes(std::shared_ptr<FileWatcher> watcher, std::vector<std::string>& files) -> bool;
+
+} // namespace Application
\ No newline at end of file
@@ -0,0 +1,42 @@
+#include "Frustum.hpp"
+
+namespace Game {
+
+static auto make_plane(const vec4& equation) -> Plane {
+    const auto length = glm::length(vec3 { equation.x, equation.y, equation.z });
+    const auto normal = vec3 { equation.x, equation.y, equation.z } / length;
+    const auto position = normal * (-equation.w / length);
+
+    return Plane { .normal = vec4 { normal.x, normal.y, normal.z, 0.0f }, .position = vec4 { position.x, position.y, position.z, 1.0f } };
+}
+
+// Gribb and Hartmann: every plane is the last row of the matrix plus or minus another
+auto get_frustum(const mat4& view_projection) -> Frustum {
+    const auto row = [&view_projection](int i) {
+        return vec4 { view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i] };
+    };
+
+    return Frustum {
+        .nearPlan = make_plane(row(3) + row(2)),
+        .farPlane = make_plane(row(3) - row(2)),
+        .left = make_plane(row(3) + row(0)),
+        .right = make_plane(row(3) - row(0)),
+        .top = make_plane(row(3) - row(1)),
+        .bottom = make_plane(row(3) + row(1)),
+    };
+}
+
+auto is_box_visible(const Frustum& frustum, const vec3& lo, const vec3& hi) -> bool {
+    for (const auto& plane : { frustum.nearPlan, frustum.farPlane, frustum.left, frustum.right, frustum.top, frustum.bottom }) {
+        // The corner furthest along the normal decides
+        const auto corner = vec3 { plane.normal.x >= 0.0f ? hi.x : lo.x, plane.normal.y >= 0.0f ? hi.y : lo.y, plane.normal.z >= 0.0f ? hi.z : lo.z };
+        const auto offset = corner - vec3 { plane.position.x, plane.position.y, plane.position.z };
+        if (glm::dot(vec3 { plane.normal.x, plane.normal.y, plane.normal.z }, offset) < 0.0f) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace Game
\ No newline at end of file
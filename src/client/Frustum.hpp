@@ -13,4 +13,10 @@ struct Frustum {
     Plane bottom;
 };
 
+// Planes of a view-projection matrix with their normals pointing inwards.
+auto get_frustum(const mat4& view_projection) -> Frustum;
+
+// Conservative: boxes crossing a corner of the frustum may be reported visible.
+auto is_box_visible(const Frustum& frustum, const vec3& lo, const vec3& hi) -> bool;
+
 } // namespace Game
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "Generator.hpp"
+#include "World.hpp"
+
+#include <algorithm>
+
+namespace Game {
+
+static auto floor_div(int32_t value, int32_t divisor) -> int32_t {
+    return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
+}
+
+auto generate_column(World& world, const ivec2& column, std::span<const int32_t> heights, const TerrainLayers& layers) -> size_t {
+    constexpr auto size = static_cast<int32_t>(Chunk::Size);
+
+    if (std::size(heights) < Chunk::Size * Chunk::Size) {
+        return 0;
+    }
+
+    const auto [lowest, highest] = std::minmax_element(std::begin(heights), std::begin(heights) + Chunk::Size * Chunk::Size);
+
+    // Everything below the lowest soil layer is stone in every column
+    const auto bottom = floor_div(*lowest - layers.soil_depth, size);
+    const auto top = floor_div(*highest, size);
+
+    auto& info = world._columns[column_key(column)];
+    info.bottom = bottom;
+    info.fill = layers.stone;
+
+    size_t added = 0;
+
+    for (auto cy = top; cy >= bottom; cy--) {
+        auto& chunk = add_chunk(world, create_chunk({ column.x, cy, column.y }));
+        const auto base = cy * size;
+
+        // Layers below the lowest soil are stone everywhere, whole sections of them are
+        // summarised by fill_chunk; only the layers above are written voxel by voxel.
+        const auto stone_end = std::clamp(*lowest - layers.soil_depth - base, 0, size);
+        fill_chunk(chunk, 0, static_cast<size_t>(stone_end), layers.stone);
+
+        const auto written_end = std::clamp(*highest - base + 1, stone_end, size);
+
+        for (size_t x = 0; x < Chunk::Size; x++) {
+            for (size_t z = 0; z < Chunk::Size; z++) {
+                const auto height = heights[x * Chunk::Size + z];
+                const auto end = std::min(height - base + 1, size);
+
+                for (auto y = std::max(stone_end, height - layers.soil_depth - base); y < end; y++) {
+                    chunk._blocks[y][x][z] = base + y == height ? layers.surface : layers.soil;
+                }
+                for (auto y = stone_end; y < std::min(height - layers.soil_depth - base, size); y++) {
+                    chunk._blocks[y][x][z] = layers.stone;
+                }
+            }
+        }
+
+        for (auto s = static_cast<size_t>(stone_end) / Chunk::SectionSize; s * Chunk::SectionSize < static_cast<size_t>(written_end); s++) {
+            update_chunk_section(chunk, s);
+        }
+
+        chunk._dirty_sections = static_cast<uint8_t>((1u << Chunk::SectionCount) - 1);
+        added++;
+    }
+
+    return added;
+}
+
+} // namespace Game
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Math.hpp"
+
+#include <span>
+
+namespace Game {
+
+struct World;
+
+struct TerrainLayers {
+    uint32_t surface = 0;
+    uint32_t soil = 0;
+    uint32_t stone = 0;
+    int32_t soil_depth = 3;
+};
+
+// Fills the column from a Size * Size height map indexed [x * Size + z], heights in
+// world blocks. Only chunks crossing the surface band are allocated: sky above stays
+// empty and the stone below becomes the column's implicit fill. Chunks are added top
+// down and not lit; returns how many were added.
+auto generate_column(World& world, const ivec2& column, std::span<const int32_t> heights, const TerrainLayers& layers) -> size_t;
+
+} // namespace Game
\ No newline at end of file
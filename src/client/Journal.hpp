@@ -1,9 +1,13 @@
 #pragma once
 
+#include "Memory.hpp"
+
 #include <fmt/chrono.h>
 #include <fmt/color.h>
 #include <fmt/core.h>
+#include <fmt/format.h>
 #include <fmt/ranges.h>
+#include <iterator>
 #include <string>
 #include <string_view>
 
@@ -11,52 +15,63 @@ namespace Journal {
 
 namespace v3 {
 
+    // Lines are formatted into a buffer charged to Memory::Subsystem::Journal. It is
+    // released once printed, so the subsystem's peak and total are what logging costs.
+    using LineBuffer = fmt::basic_memory_buffer<char, 1, Memory::TrackedAllocator<char, Memory::Subsystem::Journal>>;
+
+    template <typename... Args> inline auto format_line(const fmt::text_style& style, Args&&... args) -> LineBuffer {
+        LineBuffer line;
+        line.reserve(256);
+        fmt::format_to(std::back_inserter(line), style, std::forward<Args>(args)...);
+        return line;
+    }
+
     template <typename... Args> inline auto critical(const std::string_view tag, Args&&... args) -> void {
         const auto t = std::time(nullptr);
         const auto style = bg(fmt::terminal_color::red) | fmt::emphasis::bold;
-        const auto str = fmt::format(style, std::forward<Args>(args)...);
+        const auto line = format_line(style, std::forward<Args>(args)...);
 
-        fmt::print("{:%Y-%m-%d %H-%M-%S} C: [{}] {}\n", fmt::localtime(t), tag, str);
+        fmt::print("{:%Y-%m-%d %H-%M-%S} C: [{}] {}\n", fmt::localtime(t), tag, fmt::string_view { line.data(), line.size() });
     }
 
     template <typename... Args> inline auto error(const std::string_view tag, Args&&... args) -> void {
         const auto t = std::time(nullptr);
         const auto style = fg(fmt::terminal_color::bright_red);
-        const auto str = fmt::format(style, std::forward<Args>(args)...);
+        const auto line = format_line(style, std::forward<Args>(args)...);
 
-        fmt::print("{:%Y-%m-%d %H-%M-%S} E: [{}] {}\n", fmt::localtime(t), tag, str);
+        fmt::print("{:%Y-%m-%d %H-%M-%S} E: [{}] {}\n", fmt::localtime(t), tag, fmt::string_view { line.data(), line.size() });
     }
 
     template <typename... Args> inline auto warning(const std::string_view tag, Args&&... args) -> void {
         const auto t = std::time(nullptr);
         const auto style = fg(fmt::terminal_color::bright_yellow);
-        const auto str = fmt::format(style, std::forward<Args>(args)...);
+        const auto line = format_line(style, std::forward<Args>(args)...);
 
-        fmt::print("{:%Y-%m-%d %H-%M-%S} W: [{}] {}\n", fmt::localtime(t), tag, str);
+        fmt::print("{:%Y-%m-%d %H-%M-%S} W: [{}] {}\n", fmt::localtime(t), tag, fmt::string_view { line.data(), line.size() });
     }
 
     template <typename... Args> inline auto message(const std::string_view tag, Args&&... args) -> void {
         const auto t = std::time(nullptr);
         const auto style = fg(fmt::terminal_color::green);
-        const auto str = fmt::format(style, std::forward<Args>(args)...);
+        const auto line = format_line(style, std::forward<Args>(args)...);
 
-        fmt::print("{:%Y-%m-%d %H-%M-%S} I: [{}] {}\n", fmt::localtime(t), tag, str);
+        fmt::print("{:%Y-%m-%d %H-%M-%S} I: [{}] {}\n", fmt::localtime(t), tag, fmt::string_view { line.data(), line.size() });
     }
 
     template <typename... Args> inline auto debug(const std::string_view tag, Args&&... args) -> void {
         const auto t = std::time(nullptr);
         const auto style = fg(fmt::terminal_color::cyan);
-        const auto str = fmt::format(style, std::forward<Args>(args)...);
+        const auto line = format_line(style, std::forward<Args>(args)...);
 
-        fmt::print("{:%Y-%m-%d %H-%M-%S} D: [{}] {}\n", fmt::localtime(t), tag, str);
+        fmt::print("{:%Y-%m-%d %H-%M-%S} D: [{}] {}\n", fmt::localtime(t), tag, fmt::string_view { line.data(), line.size() });
     }
 
     template <typename... Args> inline auto verbose(const std::string_view tag, Args&&... args) -> void {
         const auto t = std::time(nullptr);
         const auto style = fg(fmt::terminal_color::blue);
-        const auto str = fmt::format(style, std::forward<Args>(args)...);
+        const auto line = format_line(style, std::forward<Args>(args)...);
 
-        fmt::print("{:%Y-%m-%d %H-%M-%S} V: [{}] {}\n", fmt::localtime(t), tag, str);
+        fmt::print("{:%Y-%m-%d %H-%M-%S} V: [{}] {}\n", fmt::localtime(t), tag, fmt::string_view { line.data(), line.size() });
     }
 
 } // namespace v3
@@ -0,0 +1,450 @@
+#include "Lighting.hpp"
+#include "World.hpp"
+
+#include <algorithm>
+#include <array>
+#include <queue>
+
+namespace Game {
+
+struct LightNode {
+    ivec3 position = ivec3 { 0, 0, 0 };
+    uint8_t level = 0;
+};
+
+using LightQueue = std::queue<LightNode>;
+
+static const ivec3 Directions[] = { { 0, 0, -1 }, { -1, 0, 0 }, { 1, 0, 0 }, { 0, 0, 1 }, { 0, 1, 0 }, { 0, -1, 0 } };
+static constexpr size_t Front = 0, Left = 1, Right = 2, Back = 3, Up = 4, Down = 5;
+
+// Resolves world positions to chunk cells. BFS steps rarely leave the current
+// chunk, so the last lookup is kept to avoid hashing on every step, and so are
+// the neighbours of that chunk once set_level needed them.
+struct LightCursor {
+    World& world;
+    Chunk* chunk = nullptr;
+    ivec3 chunk_position = ivec3 { 0, 0, 0 };
+    ivec3 local = ivec3 { 0, 0, 0 };
+    std::array<Chunk*, std::size(Directions)> neighbours = {}; // in Directions order
+    uint8_t known = 0; // bit per neighbour looked up since the chunk changed
+};
+
+static auto seek(LightCursor& cursor, const ivec3& position) -> bool {
+    const auto chunk_position = world_to_chunk(position);
+    if (!cursor.chunk || chunk_position != cursor.chunk_position) {
+        cursor.chunk = find_chunk(cursor.world, chunk_position);
+        cursor.chunk_position = chunk_position;
+        cursor.known = 0;
+    }
+
+    if (!cursor.chunk) {
+        return false;
+    }
+
+    cursor.local = world_to_local(position);
+    return true;
+}
+
+static auto get_neighbour(LightCursor& cursor, size_t direction) -> Chunk* {
+    if ((cursor.known & (1u << direction)) == 0) {
+        cursor.neighbours[direction] = find_chunk(cursor.world, cursor.chunk_position + Directions[direction]);
+        cursor.known |= static_cast<uint8_t>(1u << direction);
+    }
+
+    return cursor.neighbours[direction];
+}
+
+static auto is_opaque(const LightCursor& cursor) -> bool {
+    return cursor.chunk->_blocks[cursor.local.y][cursor.local.x][cursor.local.z] != 0;
+}
+
+static auto get_level(const LightCursor& cursor, bool sun) -> uint8_t {
+    const auto& l = cursor.local;
+    return sun ? get_sunlight(*cursor.chunk, l.x, l.y, l.z) : get_blocklight(*cursor.chunk, l.x, l.y, l.z);
+}
+
+static auto set_level(LightCursor& cursor, bool sun, uint8_t level) -> void {
+    const auto& l = cursor.local;
+    if (sun) {
+        set_sunlight(*cursor.chunk, l.x, l.y, l.z, level);
+    } else {
+        set_blocklight(*cursor.chunk, l.x, l.y, l.z, level);
+    }
+
+    // Faces of the neighbouring section may look into this cell as well
+    const auto y = static_cast<size_t>(l.y);
+    const auto s = y / Chunk::SectionSize;
+    auto dirty = 1u << s;
+    if (y % Chunk::SectionSize == 0 && s > 0) {
+        dirty |= 1u << (s - 1);
+    }
+    if (y % Chunk::SectionSize == Chunk::SectionSize - 1 && s + 1 < Chunk::SectionCount) {
+        dirty |= 1u << (s + 1);
+    }
+
+    cursor.chunk->_dirty_sections |= static_cast<uint8_t>(dirty);
+
+    // ... and so may the border cells of the neighbouring chunks
+    const auto mark = [&cursor](size_t direction, uint32_t sections) {
+        if (auto neighbour = get_neighbour(cursor, direction); neighbour) {
+            neighbour->_dirty_sections |= static_cast<uint8_t>(sections);
+        }
+    };
+
+    constexpr auto last = static_cast<int32_t>(Chunk::Size - 1);
+    if (y == 0 || y == Chunk::Size - 1) {
+        mark(y == 0 ? Down : Up, y == 0 ? 1u << (Chunk::SectionCount - 1) : 1u);
+    }
+    if (l.x == 0 || l.x == last) {
+        mark(l.x == 0 ? Left : Right, 1u << s);
+    }
+    if (l.z == 0 || l.z == last) {
+        mark(l.z == 0 ? Front : Back, 1u << s);
+    }
+}
+
+static auto get_emission(const BlockTypes& block_types, uint32_t block) -> uint8_t {
+    if (block == 0 || block >= std::size(block_types)) {
+        return 0;
+    }
+
+    return static_cast<uint8_t>(std::min<uint32_t>(block_types[block].light, Chunk::MaxLight));
+}
+
+static auto propagate_light(World& world, LightQueue& queue, bool sun) -> void {
+    LightCursor cursor { world };
+
+    while (!queue.empty()) {
+        const auto node = queue.front();
+        queue.pop();
+
+        if (!seek(cursor, node.position)) {
+            continue;
+        }
+
+        const auto level = get_level(cursor, sun);
+        if (level <= 1) {
+            continue;
+        }
+
+        for (size_t d = 0; d < std::size(Directions); d++) {
+            const auto neighbour = node.position + Directions[d];
+            if (!seek(cursor, neighbour) || is_opaque(cursor)) {
+                continue;
+            }
+
+            // Full sunlight falls straight down without fading
+            const auto next = (sun && d == Down && level == Chunk::MaxLight) ? level : static_cast<uint8_t>(level - 1);
+            if (get_level(cursor, sun) >= next) {
+                continue;
+            }
+
+            set_level(cursor, sun, next);
+            queue.push({ neighbour, next });
+        }
+    }
+}
+
+// Darkens everything that was lit by the removed nodes and collects the
+// brighter cells at the boundary, which then refill the hole via propagate.
+static auto remove_light(World& world, LightQueue& removal, LightQueue& queue, bool sun) -> void {
+    LightCursor cursor { world };
+
+    while (!removal.empty()) {
+        const auto node = removal.front();
+        removal.pop();
+
+        for (size_t d = 0; d < std::size(Directions); d++) {
+            const auto neighbour = node.position + Directions[d];
+            if (!seek(cursor, neighbour)) {
+                continue;
+            }
+
+            const auto level = get_level(cursor, sun);
+            if (level == 0) {
+                continue;
+            }
+
+            if (level < node.level || (sun && d == Down && node.level == Chunk::MaxLight)) {
+                set_level(cursor, sun, 0);
+                removal.push({ neighbour, level });
+            } else {
+                queue.push({ neighbour, level });
+            }
+        }
+    }
+}
+
+auto light_chunk(World& world, Chunk& chunk, const BlockTypes& block_types) -> void {
+    const auto origin = chunk_origin(chunk._position);
+
+    std::fill_n(&chunk._light[0][0][0], Chunk::Size * Chunk::Size * Chunk::Size, uint8_t { 0 });
+
+    // Sunlight enters through the top from a loaded chunk above, or from open sky
+    const auto above = find_chunk(world, chunk._position + ivec3 { 0, 1, 0 });
+    const auto open = !above && is_open_sky(world, chunk._position + ivec3 { 0, 1, 0 });
+
+    // Under open sky everything above the highest non-empty section is lit
+    const auto sky = open ? get_chunk_extent(chunk).second : Chunk::Size;
+    if (sky < Chunk::Size) {
+        std::fill_n(&chunk._light[sky][0][0], (Chunk::Size - sky) * Chunk::Size * Chunk::Size, uint8_t { Chunk::MaxLight << 4 });
+    }
+
+    size_t floors[Chunk::Size][Chunk::Size];
+    for (size_t x = 0; x < Chunk::Size; x++) {
+        for (size_t z = 0; z < Chunk::Size; z++) {
+            const auto lit = open || (above && above->_blocks[0][x][z] == 0 && get_sunlight(*above, x, 0, z) == Chunk::MaxLight);
+            if (!lit) {
+                floors[x][z] = Chunk::Size;
+                continue;
+            }
+
+            auto y = sky;
+            while (y > 0 && chunk._blocks[y - 1][x][z] == 0) {
+                y--;
+                set_sunlight(chunk, x, y, z, Chunk::MaxLight);
+            }
+            floors[x][z] = y;
+        }
+    }
+
+    const ivec3 sides[6] = { { -1, 0, 0 }, { 1, 0, 0 }, { 0, 0, -1 }, { 0, 0, 1 }, { 0, 1, 0 }, { 0, -1, 0 } };
+    const Chunk* neighbours[6];
+    for (size_t n = 0; n < std::size(sides); n++) {
+        neighbours[n] = find_chunk(world, chunk._position + sides[n]);
+    }
+
+    LightQueue sun_queue;
+    LightQueue block_queue;
+
+    // Only sky cells next to a deeper column (or a loaded neighbour chunk) can spread sideways,
+    // and only columns lit to the bottom can reach the chunk below
+    for (size_t x = 0; x < Chunk::Size; x++) {
+        for (size_t z = 0; z < Chunk::Size; z++) {
+            auto top = floors[x][z];
+            top = std::max(top, x > 0 ? floors[x - 1][z] : (neighbours[0] ? Chunk::Size : 0));
+            top = std::max(top, x + 1 < Chunk::Size ? floors[x + 1][z] : (neighbours[1] ? Chunk::Size : 0));
+            top = std::max(top, z > 0 ? floors[x][z - 1] : (neighbours[2] ? Chunk::Size : 0));
+            top = std::max(top, z + 1 < Chunk::Size ? floors[x][z + 1] : (neighbours[3] ? Chunk::Size : 0));
+
+            for (auto y = floors[x][z]; y < top; y++) {
+                sun_queue.push({ origin + ivec3 { x, y, z }, Chunk::MaxLight });
+            }
+
+            if (floors[x][z] == 0 && top == 0 && neighbours[5]) {
+                sun_queue.push({ origin + ivec3 { x, 0, z }, Chunk::MaxLight });
+            }
+        }
+    }
+
+    // Pull light in from the border cells of loaded neighbours
+    const auto border = [](int32_t d, size_t free) { return d == 0 ? free : (d < 0 ? Chunk::Size - 1 : 0); };
+    for (size_t n = 0; n < std::size(sides); n++) {
+        if (!neighbours[n]) {
+            continue;
+        }
+
+        const auto& neighbour = *neighbours[n];
+        const auto neighbour_origin = chunk_origin(neighbour._position);
+        const auto& side = sides[n];
+
+        for (size_t i = 0; i < Chunk::Size; i++) {
+            for (size_t j = 0; j < Chunk::Size; j++) {
+                const auto x = border(side.x, i);
+                const auto y = border(side.y, side.x == 0 ? j : i);
+                const auto z = border(side.z, j);
+
+                const auto sun = get_sunlight(neighbour, x, y, z);
+                const auto light = get_blocklight(neighbour, x, y, z);
+                const auto position = neighbour_origin + ivec3 { x, y, z };
+
+                if (sun > 1) {
+                    sun_queue.push({ position, sun });
+                }
+                if (light > 1) {
+                    block_queue.push({ position, light });
+                }
+            }
+        }
+    }
+
+    const auto emissive = std::any_of(std::begin(block_types), std::end(block_types), [](const auto& bt) { return bt.light > 0; });
+    for (size_t s = 0; emissive && s < Chunk::SectionCount; s++) {
+        const auto& section = chunk._sections[s];
+        if (is_section_empty(section) || (section._uniform && get_emission(block_types, section._block) == 0)) {
+            continue;
+        }
+
+        for (size_t y = s * Chunk::SectionSize; y < (s + 1) * Chunk::SectionSize; y++) {
+            for (size_t x = 0; x < Chunk::Size; x++) {
+                for (size_t z = 0; z < Chunk::Size; z++) {
+                    const auto emission = get_emission(block_types, chunk._blocks[y][x][z]);
+                    if (emission > 0) {
+                        set_blocklight(chunk, x, y, z, emission);
+                        block_queue.push({ origin + ivec3 { x, y, z }, emission });
+                    }
+                }
+            }
+        }
+    }
+
+    propagate_light(world, sun_queue, true);
+    propagate_light(world, block_queue, false);
+
+    chunk._dirty_sections = static_cast<uint8_t>((1u << Chunk::SectionCount) - 1);
+}
+
+auto update_light(World& world, const BlockTypes& block_types, std::span<const BlockChange> changes) -> void {
+    LightCursor cursor { world };
+
+    LightQueue sun_removal;
+    LightQueue block_removal;
+    LightQueue sun_queue;
+    LightQueue block_queue;
+
+    for (const auto& change : changes) {
+        const auto& position = change.position;
+        if (!seek(cursor, position)) {
+            continue;
+        }
+
+        if (is_opaque(cursor)) {
+            // Placed: the cell no longer carries light of either kind
+            const auto sun = get_level(cursor, true);
+            const auto light = get_level(cursor, false);
+
+            set_level(cursor, true, 0);
+            set_level(cursor, false, 0);
+
+            if (sun > 0) {
+                sun_removal.push({ position, sun });
+            }
+            if (light > 0) {
+                block_removal.push({ position, light });
+            }
+            continue;
+        }
+
+        // Removed: drop the old emission and let the neighbours flow back in
+        if (get_emission(block_types, change.old_block) > 0) {
+            const auto light = get_level(cursor, false);
+            set_level(cursor, false, 0);
+            block_removal.push({ position, light });
+        }
+
+        const auto up = position + ivec3 { 0, 1, 0 };
+        if (const auto up_chunk = world_to_chunk(up); !find_chunk(world, up_chunk) && is_open_sky(world, up_chunk)) {
+            set_level(cursor, true, Chunk::MaxLight);
+            sun_queue.push({ position, Chunk::MaxLight });
+        }
+
+        for (const auto& direction : Directions) {
+            const auto neighbour = position + direction;
+            if (!seek(cursor, neighbour)) {
+                continue;
+            }
+
+            if (const auto sun = get_level(cursor, true); sun > 0) {
+                sun_queue.push({ neighbour, sun });
+            }
+            if (const auto light = get_level(cursor, false); light > 0) {
+                block_queue.push({ neighbour, light });
+            }
+        }
+    }
+
+    remove_light(world, sun_removal, sun_queue, true);
+    remove_light(world, block_removal, block_queue, false);
+
+    for (const auto& change : changes) {
+        if (!seek(cursor, change.position)) {
+            continue;
+        }
+
+        const auto block = cursor.chunk->_blocks[cursor.local.y][cursor.local.x][cursor.local.z];
+        if (const auto emission = get_emission(block_types, block); emission > 0) {
+            set_level(cursor, false, emission);
+            block_queue.push({ change.position, emission });
+        }
+    }
+
+    propagate_light(world, sun_queue, true);
+    propagate_light(world, block_queue, false);
+}
+
+auto relight_blocks(World& world, const BlockTypes& block_types, std::span<const uint32_t> blocks) -> size_t {
+    if (blocks.empty()) {
+        return 0;
+    }
+
+    std::vector<uint8_t> affected(*std::max_element(std::begin(blocks), std::end(blocks)) + 1, 0);
+    for (const auto block : blocks) {
+        affected[block] = 1;
+    }
+
+    const auto is_affected = [&affected](uint32_t block) { return block < std::size(affected) && affected[block] != 0; };
+
+    std::vector<ivec3> cells;
+    for (const auto& pointer : world._chunks) {
+        const auto& chunk = *pointer;
+        const auto origin = chunk_origin(chunk._position);
+
+        for (size_t s = 0; s < Chunk::SectionCount; s++) {
+            const auto& section = chunk._sections[s];
+            if (section._uniform && !is_affected(section._block)) {
+                continue;
+            }
+
+            for (size_t y = s * Chunk::SectionSize; y < (s + 1) * Chunk::SectionSize; y++) {
+                for (size_t x = 0; x < Chunk::Size; x++) {
+                    for (size_t z = 0; z < Chunk::Size; z++) {
+                        if (is_affected(chunk._blocks[y][x][z])) {
+                            cells.push_back(origin + ivec3 { x, y, z });
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    LightCursor cursor { world };
+    LightQueue block_removal;
+    LightQueue block_queue;
+
+    // Take back the old emission, then emit at the new level
+    for (const auto& position : cells) {
+        if (!seek(cursor, position)) {
+            continue;
+        }
+
+        if (const auto light = get_level(cursor, false); light > 0) {
+            set_level(cursor, false, 0);
+            block_removal.push({ position, light });
+        }
+    }
+
+    remove_light(world, block_removal, block_queue, false);
+
+    for (const auto& position : cells) {
+        if (!seek(cursor, position)) {
+            continue;
+        }
+
+        const auto block = cursor.chunk->_blocks[cursor.local.y][cursor.local.x][cursor.local.z];
+        if (const auto emission = get_emission(block_types, block); emission > 0) {
+            set_level(cursor, false, emission);
+            block_queue.push({ position, emission });
+        }
+    }
+
+    propagate_light(world, block_queue, false);
+
+    return std::size(cells);
+}
+
+auto update_light(World& world, const BlockTypes& block_types, const ivec3& position, uint32_t old_block) -> void {
+    const BlockChange change { .position = position, .old_block = old_block, .new_block = get_block(world, position) };
+    update_light(world, block_types, std::span { &change, 1 });
+}
+
+} // namespace Game
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Block.hpp"
+#include "Edit.hpp"
+#include "Math.hpp"
+
+#include <span>
+
+namespace Game {
+
+struct World;
+struct Chunk;
+
+// Computes sunlight and block light of a freshly loaded chunk, pulling in light
+// from loaded neighbours and pushing its own light across the borders.
+auto light_chunk(World& world, Chunk& chunk, const BlockTypes& block_types) -> void;
+
+// Relights the neighbourhood of a single changed block. Must be called after the
+// new block is written; old_block is the id it replaced.
+auto update_light(World& world, const BlockTypes& block_types, const ivec3& position, uint32_t old_block) -> void;
+
+// Relights a batch of changes with one removal and one propagation pass.
+auto update_light(World& world, const BlockTypes& block_types, std::span<const BlockChange> changes) -> void;
+
+// Re-emits every loaded cell of the given blocks after their light level changed.
+auto relight_blocks(World& world, const BlockTypes& block_types, std::span<const uint32_t> blocks) -> size_t;
+
+} // namespace Game
\ No newline at end of file
@@ -0,0 +1,226 @@
+#include "Lod.hpp"
+#include "World.hpp"
+
+#include <cmath>
+
+namespace Game {
+
+using Cells = std::vector<uint32_t>;
+
+static auto push_face(Chunk& chunk, const std::vector<vec3>& face, const vec3& center, float scale, const vec3& color, uint32_t texture)
+    -> void {
+    chunk._vertices.push_back({ face[0] * scale + center, color, vec3(0.0f, scale, texture) });
+    chunk._vertices.push_back({ face[1] * scale + center, color, vec3(scale, scale, texture) });
+    chunk._vertices.push_back({ face[2] * scale + center, color, vec3(scale, 0.0f, texture) });
+    chunk._vertices.push_back({ face[3] * scale + center, color, vec3(0.0f, 0.0f, texture) });
+
+    chunk._indices.push_back(chunk._vertex_count);
+    chunk._indices.push_back(chunk._vertex_count + 1);
+    chunk._indices.push_back(chunk._vertex_count + 2);
+    chunk._indices.push_back(chunk._vertex_count + 2);
+    chunk._indices.push_back(chunk._vertex_count + 3);
+    chunk._indices.push_back(chunk._vertex_count);
+
+    chunk._vertex_count += 4;
+    chunk._index_count += 6;
+}
+
+static auto pick_cell(const Chunk& chunk, size_t factor, size_t x0, size_t y0, size_t z0) -> uint32_t {
+    // Cells never straddle sections, so uniform sections need no scan
+    const auto& section = chunk._sections[y0 / Chunk::SectionSize];
+    if (section._uniform) {
+        return section._block;
+    }
+
+    size_t solid = 0;
+    uint32_t top = 0;
+
+    for (auto y = y0 + factor; y-- > y0;) {
+        for (auto x = x0; x < x0 + factor; x++) {
+            for (auto z = z0; z < z0 + factor; z++) {
+                const auto block = chunk._blocks[y][x][z];
+                if (block != 0) {
+                    solid++;
+                    top = top != 0 ? top : block;
+                }
+            }
+        }
+    }
+
+    return solid * 2 >= factor * factor * factor ? top : 0;
+}
+
+static auto downsample(const Chunk& chunk, size_t factor, Cells& cells) -> void {
+    const auto n = Chunk::Size / factor;
+    cells.assign(n * n * n, 0);
+
+    for (size_t cy = 0; cy < n; cy++) {
+        if (is_section_empty(chunk._sections[cy * factor / Chunk::SectionSize])) {
+            continue;
+        }
+
+        for (size_t cx = 0; cx < n; cx++) {
+            for (size_t cz = 0; cz < n; cz++) {
+                cells[(cy * n + cx) * n + cz] = pick_cell(chunk, factor, cx * factor, cy * factor, cz * factor);
+            }
+        }
+    }
+}
+
+auto build_chunk_lod(Chunk& chunk, const BlockTypes& block_types, uint32_t lod, const ChunkNeighbours& neighbours) -> void {
+    if (lod == 0) {
+        build_chunk(chunk, block_types, neighbours);
+        return;
+    }
+
+    const auto factor = size_t { 1 } << std::min(lod, Chunk::LodCount - 1);
+    const auto n = static_cast<int32_t>(Chunk::Size / factor);
+    const auto scale = static_cast<float>(factor);
+    const auto offset = (scale - 1.0f) * 0.5f;
+
+    Cells cells;
+    downsample(chunk, factor, cells);
+
+    const auto cell_at = [&](int32_t x, int32_t y, int32_t z) -> uint32_t {
+        if (x < 0 || y < 0 || z < 0 || x >= n || y >= n || z >= n) {
+            return 0;
+        }
+        return cells[(static_cast<size_t>(y) * n + x) * n + z];
+    };
+
+    // Shade by a voxel in the middle of the neighbouring cell, in a neighbouring chunk
+    // across the border as face_light does. Only one of the coordinates is ever out of range.
+    const auto light_at = [&](int32_t x, int32_t y, int32_t z) -> vec3 {
+        const Chunk* source = &chunk;
+        if (x < 0 || x >= n) {
+            source = x < 0 ? neighbours.left : neighbours.right;
+        } else if (y < 0 || y >= n) {
+            source = y < 0 ? neighbours.below : neighbours.above;
+        } else if (z < 0 || z >= n) {
+            source = z < 0 ? neighbours.front : neighbours.back;
+        }
+
+        if (!source) {
+            return vec3 { get_light_intensity(Chunk::MaxLight) };
+        }
+
+        const auto half = factor / 2;
+        const auto vx = static_cast<size_t>((x + n) % n) * factor + half;
+        const auto vy = static_cast<size_t>((y + n) % n) * factor + half;
+        const auto vz = static_cast<size_t>((z + n) % n) * factor + half;
+        return vec3 { get_light_intensity(std::max(get_sunlight(*source, vx, vy, vz), get_blocklight(*source, vx, vy, vz))) };
+    };
+
+    chunk._vertices.clear();
+    chunk._indices.clear();
+    chunk._vertices.reserve(chunk._vertex_count);
+    chunk._indices.reserve(chunk._index_count);
+    chunk._vertex_count = 0;
+    chunk._index_count = 0;
+
+    for (int32_t y = 0; y < n; y++) {
+        for (int32_t x = 0; x < n; x++) {
+            for (int32_t z = 0; z < n; z++) {
+                const auto block_index = cell_at(x, y, z);
+                if (block_index == 0) {
+                    continue;
+                }
+
+                const auto& block_type = get_block_type(block_types, block_index);
+                const auto center = vec3 { x, y, z } * scale + vec3 { offset };
+
+                if (cell_at(x, y, z - 1) == 0) {
+                    push_face(chunk, BlockFrontFace, center, scale, block_type.frontColor * light_at(x, y, z - 1), block_type.frontTexture);
+                }
+
+                if (cell_at(x - 1, y, z) == 0) {
+                    push_face(chunk, BlockLeftFace, center, scale, block_type.leftColor * light_at(x - 1, y, z), block_type.leftTexture);
+                }
+
+                if (cell_at(x + 1, y, z) == 0) {
+                    push_face(chunk, BlockRightFace, center, scale, block_type.rightColor * light_at(x + 1, y, z), block_type.rightTexture);
+                }
+
+                if (cell_at(x, y, z + 1) == 0) {
+                    push_face(chunk, BlockBackFace, center, scale, block_type.backColor * light_at(x, y, z + 1), block_type.backTexture);
+                }
+
+                if (cell_at(x, y + 1, z) == 0) {
+                    push_face(chunk, BlockTopFace, center, scale, block_type.topColor * light_at(x, y + 1, z), block_type.topTexture);
+                }
+
+                if (cell_at(x, y - 1, z) == 0) {
+                    push_face(chunk, BlockBottomFace, center, scale, block_type.bottomColor * light_at(x, y - 1, z), block_type.bottomTexture);
+                }
+            }
+        }
+    }
+
+    chunk._dirty_sections = 0;
+}
+
+auto get_lod_settings(int32_t view_distance) -> LodSettings {
+    const auto radius = static_cast<float>(std::max(view_distance, 1)) * static_cast<float>(Chunk::Size);
+
+    LodSettings settings;
+    for (size_t i = 0; i < std::size(settings.distances); i++) {
+        settings.distances[i] = radius * static_cast<float>(i + 2) / static_cast<float>(Chunk::LodCount);
+    }
+
+    return settings;
+}
+
+auto select_chunk_lods(World& world, const LodSettings& settings) -> size_t {
+    const auto half = static_cast<float>(Chunk::Size) * 0.5f;
+    const auto camera = world._camera._position;
+
+    size_t changed = 0;
+
+    for (auto& pointer : world._chunks) {
+        auto& chunk = *pointer;
+        const auto center = vec3 { chunk_origin(chunk._position) } + vec3 { half };
+        const auto distance = glm::length(center - camera);
+
+        // Levels the chunk is clearly past, and the ones it could still be at; the
+        // current level is kept while it lies between so chunks on a threshold do not flicker.
+        uint32_t coarsest = 0;
+        uint32_t finest = 0;
+        for (const auto threshold : settings.distances) {
+            coarsest += distance > threshold - settings.hysteresis ? 1 : 0;
+            finest += distance > threshold + settings.hysteresis ? 1 : 0;
+        }
+
+        const auto lod = std::clamp(chunk._lod, finest, coarsest);
+
+        if (lod != chunk._lod) {
+            chunk._lod = lod;
+            chunk._dirty_sections = static_cast<uint8_t>((1u << Chunk::SectionCount) - 1);
+            changed++;
+        }
+    }
+
+    return changed;
+}
+
+auto scale_lod_distances(const LodSettings& settings, float scale, float floor) -> LodSettings {
+    auto scaled = settings;
+    for (auto& distance : scaled.distances) {
+        distance = std::max(distance * scale, std::min(distance, floor));
+    }
+
+    return scaled;
+}
+
+auto get_lod_stats(const World& world) -> LodStats {
+    LodStats stats;
+
+    for (const auto& chunk : world._chunks) {
+        const auto lod = std::min(chunk->_lod, Chunk::LodCount - 1);
+        stats.chunks[lod]++;
+        stats.triangles[lod] += chunk->_index_count / 3;
+    }
+
+    return stats;
+}
+
+} // namespace Game
\ No newline at end of file
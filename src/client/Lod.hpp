@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Block.hpp"
+#include "Chunk.hpp"
+
+#include <array>
+
+namespace Game {
+
+struct World;
+
+struct LodSettings {
+    // Camera distance up to which levels 0, 1 and 2 are used; level 3 beyond. These are
+    // get_lod_settings(4), the default view distance: change them together.
+    std::array<float, Chunk::LodCount - 1> distances = { 128.0f, 192.0f, 256.0f };
+    float hysteresis = 16.0f; // a chunk has to be this far past a distance before its level changes
+};
+
+struct LodStats {
+    std::array<size_t, Chunk::LodCount> chunks = {};
+    std::array<size_t, Chunk::LodCount> triangles = {};
+};
+
+// Thresholds at a half, three quarters and all of the view radius, so every level is
+// used within the columns a view distance keeps loaded; the outer ring gets level 3.
+auto get_lod_settings(int32_t view_distance) -> LodSettings;
+
+// Meshes the chunk with 2^lod voxels merged per cell along each axis. A cell is
+// solid when most of its voxels are, and shows the top-most block it contains.
+// Faces on the chunk border are always kept, so they act as skirts hiding the
+// cracks between neighbours of different levels. Border faces are shaded by the
+// neighbours' light, as build_chunk does.
+auto build_chunk_lod(Chunk& chunk, const BlockTypes& block_types, uint32_t lod, const ChunkNeighbours& neighbours = {}) -> void;
+
+// Picks each chunk's level from its distance to the camera and flags chunks
+// whose level changed for remeshing by update_chunk_meshes. Called every frame.
+auto select_chunk_lods(World& world, const LodSettings& settings) -> size_t;
+
+// Distances multiplied by scale, but none brought closer than floor by it.
+auto scale_lod_distances(const LodSettings& settings, float scale, float floor) -> LodSettings;
+
+auto get_lod_stats(const World& world) -> LodStats;
+
+} // namespace Game
\ No newline at end of file
@@ -19,4 +19,5 @@ using mat3 = glm::mat3;
 using mat4 = glm::mat4;
 using quat = glm::quat;
 using ivec2 = glm::ivec2;
+using ivec3 = glm::ivec3;
 using ivec4 = glm::ivec4;
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "Memory.hpp"
+#include "Journal.hpp"
+#include "Tags.hpp"
+
+#include <atomic>
+
+namespace Memory {
+
+struct Counter {
+    std::atomic_int64_t current = 0;
+    std::atomic_int64_t peak = 0;
+    std::atomic_uint64_t allocated = 0;
+    std::atomic_uint64_t allocations = 0;
+};
+
+static std::array<Counter, static_cast<size_t>(Subsystem::Count)> counters;
+
+auto track_allocation(Subsystem subsystem, size_t bytes) -> void {
+    auto& counter = counters[static_cast<size_t>(subsystem)];
+
+    const auto current = counter.current.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed) + static_cast<int64_t>(bytes);
+    counter.allocated.fetch_add(bytes, std::memory_order_relaxed);
+    counter.allocations.fetch_add(1, std::memory_order_relaxed);
+
+    auto peak = counter.peak.load(std::memory_order_relaxed);
+    while (current > peak && !counter.peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) { }
+}
+
+auto track_deallocation(Subsystem subsystem, size_t bytes) -> void {
+    counters[static_cast<size_t>(subsystem)].current.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+}
+
+auto get_usage(Subsystem subsystem) -> Usage {
+    const auto& counter = counters[static_cast<size_t>(subsystem)];
+
+    Usage usage;
+    usage.current = counter.current.load(std::memory_order_relaxed);
+    usage.peak = counter.peak.load(std::memory_order_relaxed);
+    usage.allocated = counter.allocated.load(std::memory_order_relaxed);
+    usage.allocations = counter.allocations.load(std::memory_order_relaxed);
+
+    return usage;
+}
+
+auto get_stats() -> Stats {
+    Stats stats;
+    for (size_t i = 0; i < std::size(stats); i++) {
+        stats[i] = get_usage(static_cast<Subsystem>(i));
+    }
+
+    return stats;
+}
+
+auto get_subsystem_name(Subsystem subsystem) -> std::string_view {
+    switch (subsystem) {
+    case Subsystem::Chunks:
+        return "chunks";
+    case Subsystem::Meshes:
+        return "meshes";
+    case Subsystem::FarChunks:
+        return "far chunks";
+    case Subsystem::Textures:
+        return "textures";
+    case Subsystem::Journal:
+        return "journal";
+    case Subsystem::Count:
+        break;
+    }
+
+    return "unknown";
+}
+
+// Log lines weigh kilobytes next to the megabytes of chunks
+static auto format_bytes(double bytes) -> std::string {
+    constexpr auto KiB = 1024.0;
+    constexpr auto MiB = 1024.0 * KiB;
+
+    if (bytes >= MiB) {
+        return fmt::format("{:.1f} MiB", bytes / MiB);
+    }
+    return fmt::format("{:.1f} KiB", bytes / KiB);
+}
+
+auto log_summary() -> void {
+    std::string summary;
+    for (size_t i = 0; i < static_cast<size_t>(Subsystem::Count); i++) {
+        const auto usage = get_usage(static_cast<Subsystem>(i));
+        summary += fmt::format("{}{} {}/{}/{}", i > 0 ? ", " : "", get_subsystem_name(static_cast<Subsystem>(i)),
+            format_bytes(static_cast<double>(usage.current)), format_bytes(static_cast<double>(usage.peak)),
+            format_bytes(static_cast<double>(usage.allocated)));
+    }
+
+    Journal::message(Tags::App, "Memory (live/peak/total): {}", summary);
+}
+
+} // namespace Memory
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace Memory {
+
+enum class Subsystem : uint8_t {
+    Chunks, // voxel and light storage of loaded chunks
+    Meshes, // chunk vertices and indices
+    FarChunks, // octrees of compacted chunks
+    Textures, // atlas pixels and compressed levels
+    Journal, // log lines while they are formatted and printed, mostly peak and total
+    Count,
+};
+
+struct Usage {
+    int64_t current = 0; // bytes live now
+    int64_t peak = 0;
+    uint64_t allocated = 0; // bytes ever allocated
+    uint64_t allocations = 0;
+};
+
+using Stats = std::array<Usage, static_cast<size_t>(Subsystem::Count)>;
+
+auto track_allocation(Subsystem subsystem, size_t bytes) -> void;
+auto track_deallocation(Subsystem subsystem, size_t bytes) -> void;
+
+auto get_usage(Subsystem subsystem) -> Usage;
+auto get_stats() -> Stats;
+auto get_subsystem_name(Subsystem subsystem) -> std::string_view;
+
+// One Journal line with the live, peak and total allocated bytes of every subsystem
+auto log_summary() -> void;
+
+// Standard allocator that charges its subsystem for every allocation
+template <typename T, Subsystem S> struct TrackedAllocator {
+    using value_type = T;
+
+    template <typename U> struct rebind {
+        using other = TrackedAllocator<U, S>;
+    };
+
+    TrackedAllocator() = default;
+    template <typename U> TrackedAllocator(const TrackedAllocator<U, S>&) noexcept { }
+
+    auto allocate(size_t n) -> T* {
+        track_allocation(S, n * sizeof(T));
+        return std::allocator<T> {}.allocate(n);
+    }
+
+    auto deallocate(T* p, size_t n) noexcept -> void {
+        track_deallocation(S, n * sizeof(T));
+        std::allocator<T> {}.deallocate(p, n);
+    }
+
+    template <typename U> auto operator==(const TrackedAllocator<U, S>&) const noexcept -> bool {
+        return true;
+    }
+};
+
+} // namespace Memory
\ No newline at end of file
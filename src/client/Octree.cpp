@@ -0,0 +1,295 @@
+#include "Octree.hpp"
+#include "World.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace Game {
+
+struct NodeHash {
+    auto operator()(const Octree::Node& node) const noexcept -> size_t {
+        uint64_t hash = 14695981039346656037ull;
+        for (const auto child : node) {
+            hash = (hash ^ child) * 1099511628211ull;
+        }
+        return static_cast<size_t>(hash);
+    }
+};
+
+using NodeIndex = std::unordered_map<Octree::Node, uint32_t, NodeHash>;
+
+struct OctreeLeaf {
+    uint32_t block = 0;
+    ivec3 lo = ivec3 { 0, 0, 0 };
+    int32_t size = 0;
+};
+
+static auto is_leaf(uint32_t ref) -> bool {
+    return (ref & Octree::Leaf) != 0;
+}
+
+static auto child_offset(uint32_t i, int32_t half) -> ivec3 {
+    return ivec3 { (i & 1) ? half : 0, (i & 2) ? half : 0, (i & 4) ? half : 0 };
+}
+
+static auto build_node(Octree& octree, NodeIndex& index, const Chunk& chunk, const ivec3& lo, int32_t size) -> uint32_t {
+    if (size <= static_cast<int32_t>(Chunk::SectionSize)) {
+        const auto& section = chunk._sections[lo.y / Chunk::SectionSize];
+        if (section._uniform) {
+            return Octree::Leaf | section._block;
+        }
+    }
+
+    if (size == 1) {
+        return Octree::Leaf | chunk._blocks[lo.y][lo.x][lo.z];
+    }
+
+    const auto half = size / 2;
+
+    Octree::Node node;
+    for (uint32_t i = 0; i < 8; i++) {
+        node[i] = build_node(octree, index, chunk, lo + child_offset(i, half), half);
+    }
+
+    if (is_leaf(node[0]) && std::all_of(std::begin(node), std::end(node), [&node](uint32_t child) { return child == node[0]; })) {
+        return node[0];
+    }
+
+    if (const auto it = index.find(node); it != std::end(index)) {
+        return it->second;
+    }
+
+    const auto ref = static_cast<uint32_t>(std::size(octree._nodes));
+    octree._nodes.push_back(node);
+    index.emplace(node, ref);
+
+    return ref;
+}
+
+static auto locate(const Octree& octree, const ivec3& local) -> OctreeLeaf {
+    auto ref = octree._root;
+    auto lo = ivec3 { 0, 0, 0 };
+    auto size = static_cast<int32_t>(Chunk::Size);
+
+    while (!is_leaf(ref)) {
+        size /= 2;
+        const auto i = static_cast<uint32_t>((local.x >= lo.x + size ? 1 : 0) | (local.y >= lo.y + size ? 2 : 0) | (local.z >= lo.z + size ? 4 : 0));
+        lo += child_offset(i, size);
+        ref = octree._nodes[ref][i];
+    }
+
+    return { ref & ~Octree::Leaf, lo, size };
+}
+
+static auto expand_node(const Octree& octree, Chunk& chunk, uint32_t ref, const ivec3& lo, int32_t size) -> void {
+    if (!is_leaf(ref)) {
+        const auto half = size / 2;
+        for (uint32_t i = 0; i < 8; i++) {
+            expand_node(octree, chunk, octree._nodes[ref][i], lo + child_offset(i, half), half);
+        }
+        return;
+    }
+
+    const auto block = ref & ~Octree::Leaf;
+    if (size == static_cast<int32_t>(Chunk::Size)) {
+        fill_chunk(chunk, 0, Chunk::Size, block);
+        return;
+    }
+
+    for (auto y = lo.y; y < lo.y + size; y++) {
+        for (auto x = lo.x; x < lo.x + size; x++) {
+            std::fill_n(&chunk._blocks[y][x][lo.z], size, block);
+        }
+    }
+}
+
+static auto is_node_empty(const Octree& octree, uint32_t ref, const ivec3& lo, int32_t size, const ivec3& qlo, const ivec3& qhi) -> bool {
+    for (int32_t a = 0; a < 3; a++) {
+        if (lo[a] >= qhi[a] || lo[a] + size <= qlo[a]) {
+            return true;
+        }
+    }
+
+    if (is_leaf(ref)) {
+        return (ref & ~Octree::Leaf) == 0;
+    }
+
+    const auto half = size / 2;
+    for (uint32_t i = 0; i < 8; i++) {
+        if (!is_node_empty(octree, octree._nodes[ref][i], lo + child_offset(i, half), half, qlo, qhi)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto build_octree(const Chunk& chunk) -> Octree {
+    Octree octree;
+    octree._position = chunk._position;
+
+    NodeIndex index;
+    octree._root = build_node(octree, index, chunk, ivec3 { 0, 0, 0 }, static_cast<int32_t>(Chunk::Size));
+    octree._nodes.shrink_to_fit();
+
+    return octree;
+}
+
+auto expand_octree(const Octree& octree, Chunk& chunk) -> void {
+    chunk._position = octree._position;
+    expand_node(octree, chunk, octree._root, ivec3 { 0, 0, 0 }, static_cast<int32_t>(Chunk::Size));
+    update_chunk_sections(chunk);
+}
+
+auto get_block(const Octree& octree, const ivec3& local) -> uint32_t {
+    return locate(octree, local).block;
+}
+
+auto is_region_empty(const Octree& octree, const ivec3& lo, const ivec3& hi) -> bool {
+    return is_node_empty(octree, octree._root, ivec3 { 0, 0, 0 }, static_cast<int32_t>(Chunk::Size), lo, hi);
+}
+
+auto raycast(const Octree& octree, const Ray& ray) -> RayHit {
+    constexpr auto size = static_cast<int32_t>(Chunk::Size);
+    constexpr auto infinity = std::numeric_limits<float>::infinity();
+
+    RayHit result;
+
+    const auto length = glm::length(ray.direction);
+    if (length == 0.0f) {
+        return result;
+    }
+
+    // Same cell convention as the world raycast: cell c covers [c, c + 1)
+    const auto origin = ray.origin + vec3 { 0.5f };
+    const auto direction = ray.direction / length;
+    const auto base = chunk_origin(octree._position);
+
+    // Clip the ray against the chunk box
+    auto t_enter = 0.0f;
+    auto t_exit = ray.max_distance;
+    auto normal = ivec3 { 0, 0, 0 };
+    for (int32_t a = 0; a < 3; a++) {
+        const auto lo = static_cast<float>(base[a]);
+        const auto hi = lo + static_cast<float>(size);
+
+        if (direction[a] == 0.0f) {
+            if (origin[a] < lo || origin[a] >= hi) {
+                return result;
+            }
+            continue;
+        }
+
+        auto t0 = (lo - origin[a]) / direction[a];
+        auto t1 = (hi - origin[a]) / direction[a];
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+
+        if (t0 > t_enter) {
+            t_enter = t0;
+            normal = ivec3 { 0, 0, 0 };
+            normal[a] = direction[a] > 0.0f ? -1 : 1;
+        }
+        t_exit = std::min(t_exit, t1);
+    }
+
+    if (t_enter > t_exit) {
+        return result;
+    }
+
+    auto t = t_enter;
+    ivec3 cell;
+    for (int32_t a = 0; a < 3; a++) {
+        cell[a] = std::clamp(static_cast<int32_t>(std::floor(origin[a] + direction[a] * t)), base[a], base[a] + size - 1);
+    }
+
+    // Every step leaves the current leaf, however large it is
+    while (t <= t_exit) {
+        const auto leaf = locate(octree, cell - base);
+        if (leaf.block != 0) {
+            result.hit = true;
+            result.position = cell;
+            result.normal = normal;
+            result.distance = t;
+            result.block = leaf.block;
+            return result;
+        }
+
+        const auto lo = base + leaf.lo;
+        const auto hi = lo + ivec3 { leaf.size };
+
+        auto exit = infinity;
+        auto axis = 0;
+        for (int32_t a = 0; a < 3; a++) {
+            if (direction[a] == 0.0f) {
+                continue;
+            }
+
+            const auto boundary = static_cast<float>(direction[a] > 0.0f ? hi[a] : lo[a]);
+            const auto ta = (boundary - origin[a]) / direction[a];
+            if (ta < exit) {
+                exit = ta;
+                axis = a;
+            }
+        }
+
+        t = std::max(t, exit);
+        for (int32_t a = 0; a < 3; a++) {
+            if (a == axis) {
+                cell[a] = direction[a] > 0.0f ? hi[a] : lo[a] - 1;
+            } else {
+                cell[a] = std::clamp(static_cast<int32_t>(std::floor(origin[a] + direction[a] * t)), lo[a], hi[a] - 1);
+            }
+        }
+
+        if (cell[axis] < base[axis] || cell[axis] >= base[axis] + size) {
+            break;
+        }
+
+        normal = ivec3 { 0, 0, 0 };
+        normal[axis] = direction[axis] > 0.0f ? -1 : 1;
+    }
+
+    return result;
+}
+
+auto get_octree_memory(const Octree& octree) -> size_t {
+    return sizeof(Octree) + octree._nodes.capacity() * sizeof(Octree::Node);
+}
+
+auto compact_chunk(World& world, const ivec3& position) -> bool {
+    const auto chunk = find_chunk(world, position);
+    if (!chunk) {
+        return false;
+    }
+
+    auto octree = build_octree(*chunk);
+    octree._unsaved_sections = chunk->_unsaved_sections;
+
+    // Counted before the removal so the column keeps its top
+    world._far_chunks[chunk_key(position)] = std::move(octree);
+    world._columns[column_key({ position.x, position.z })].far++;
+    remove_chunk(world, position);
+
+    return true;
+}
+
+auto expand_chunk(World& world, const ivec3& position) -> Chunk* {
+    const auto it = world._far_chunks.find(chunk_key(position));
+    if (it == std::end(world._far_chunks)) {
+        return find_chunk(world, position);
+    }
+
+    auto& chunk = add_chunk(world, create_chunk(position));
+    expand_octree(it->second, chunk);
+    chunk._unsaved_sections = it->second._unsaved_sections;
+    world._far_chunks.erase(it);
+    world._columns[column_key({ position.x, position.z })].far--;
+
+    return &chunk;
+}
+
+} // namespace Game
\ No newline at end of file
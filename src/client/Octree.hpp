@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Chunk.hpp"
+#include "Math.hpp"
+#include "Memory.hpp"
+#include "Raycast.hpp"
+
+#include <array>
+#include <vector>
+
+namespace Game {
+
+struct World;
+
+// Sparse voxel octree over one chunk. Identical subtrees are stored once, so
+// the tree is a DAG. A child reference with the Leaf bit set is a uniform
+// block of that id, otherwise it indexes _nodes.
+struct Octree {
+    using Node = std::array<uint32_t, 8>;
+    using Nodes = std::vector<Node, Memory::TrackedAllocator<Node, Memory::Subsystem::FarChunks>>;
+
+    static constexpr uint32_t Leaf = 0x80000000u;
+
+    ivec3 _position = ivec3 { 0, 0, 0 };
+    uint32_t _root = Leaf;
+    uint8_t _unsaved_sections = 0; // carried over from the chunk it was built from
+    Nodes _nodes;
+};
+
+auto build_octree(const Chunk& chunk) -> Octree;
+// Overwrites every voxel and section summary of chunk; light is left untouched.
+auto expand_octree(const Octree& octree, Chunk& chunk) -> void;
+
+// Coordinates are local to the chunk; hi is exclusive.
+auto get_block(const Octree& octree, const ivec3& local) -> uint32_t;
+auto is_region_empty(const Octree& octree, const ivec3& lo, const ivec3& hi) -> bool;
+
+// World space ray against this chunk only.
+auto raycast(const Octree& octree, const Ray& ray) -> RayHit;
+
+auto get_octree_memory(const Octree& octree) -> size_t;
+
+// Swaps a loaded chunk for its octree and back. Unsaved edits are kept, light is
+// not, so expanded chunks need light_chunk before meshing.
+auto compact_chunk(World& world, const ivec3& position) -> bool;
+auto expand_chunk(World& world, const ivec3& position) -> Chunk*;
+
+} // namespace Game
\ No newline at end of file
@@ -0,0 +1,192 @@
+#include "Raycast.hpp"
+#include "World.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Game {
+
+// Amanatides & Woo traversal that jumps over whole regions known to be empty:
+// unloaded columns, empty sections, missing chunks and the open sky above a column.
+struct RayCursor {
+    const Chunk* chunk = nullptr;
+    ivec3 chunk_position = ivec3 { 0, 0, 0 };
+    bool cached = false;
+};
+
+static auto lookup(const World& world, RayCursor& cursor, const ivec3& chunk_position) -> const Chunk* {
+    if (!cursor.cached || cursor.chunk_position != chunk_position) {
+        cursor.chunk = find_chunk(world, chunk_position);
+        cursor.chunk_position = chunk_position;
+        cursor.cached = true;
+    }
+
+    return cursor.chunk;
+}
+
+static auto trace(const World& world, RayCursor& cursor, const Ray& ray) -> RayHit {
+    constexpr auto size = static_cast<int32_t>(Chunk::Size);
+    constexpr auto section_size = static_cast<int32_t>(Chunk::SectionSize);
+    constexpr auto infinity = std::numeric_limits<float>::infinity();
+    constexpr auto far = std::numeric_limits<int32_t>::max() / 2;
+
+    RayHit result;
+
+    const auto length = glm::length(ray.direction);
+    if (length == 0.0f) {
+        return result;
+    }
+
+    // Shift by half a block so cell c covers [c, c + 1)
+    const auto origin = ray.origin + vec3 { 0.5f };
+    const auto direction = ray.direction / length;
+
+    ivec3 cell;
+    ivec3 step;
+    vec3 delta;
+    vec3 next;
+    for (int32_t a = 0; a < 3; a++) {
+        cell[a] = static_cast<int32_t>(std::floor(origin[a]));
+        step[a] = direction[a] > 0.0f ? 1 : (direction[a] < 0.0f ? -1 : 0);
+        delta[a] = step[a] != 0 ? std::abs(1.0f / direction[a]) : infinity;
+        next[a] = step[a] != 0 ? (static_cast<float>(cell[a] + (step[a] > 0 ? 1 : 0)) - origin[a]) / direction[a] : infinity;
+    }
+
+    auto t = 0.0f;
+    auto normal = ivec3 { 0, 0, 0 };
+
+    while (t <= ray.max_distance) {
+        const auto chunk_position = world_to_chunk(cell);
+
+        auto lo = chunk_origin(chunk_position);
+        auto hi = lo + ivec3 { size };
+        auto block = uint32_t { 0 };
+        auto empty = false;
+
+        if (const auto chunk = lookup(world, cursor, chunk_position); chunk) {
+            const auto local = world_to_local(cell);
+            const auto s = local.y / section_size;
+            if (is_section_empty(chunk->_sections[s])) {
+                lo.y += s * section_size;
+                hi.y = lo.y + section_size;
+                empty = true;
+            } else {
+                block = chunk->_blocks[local.y][local.x][local.z];
+            }
+        } else if (const auto it = world._far_chunks.find(chunk_key(chunk_position)); it != std::end(world._far_chunks)) {
+            // Regions before this chunk were empty, so its first hit is the nearest one
+            if (const auto hit = raycast(it->second, ray); hit.hit) {
+                return hit;
+            }
+            empty = true;
+        } else if (block = get_implicit_block(world, chunk_position); block == 0) {
+            // Skip the whole sky above the column, all of the column above its fill when no
+            // chunk is in it, or the whole column when it has no fill either. Chunk bounds
+            // are widened before scaling, top is INT32_MIN in a column without chunks.
+            const auto to_blocks = [](int64_t chunk_y) { return static_cast<int32_t>(std::clamp<int64_t>(chunk_y * size, -far, far)); };
+            const auto column = find_column(world, { chunk_position.x, chunk_position.z });
+            const auto vacant = column && column->chunks == 0 && column->far == 0;
+            if (!column || (vacant && column->fill == 0)) {
+                lo.y = -far;
+                hi.y = far;
+            } else if (vacant) {
+                lo.y = to_blocks(column->bottom);
+                hi.y = far;
+            } else if (chunk_position.y > column->top) {
+                lo.y = to_blocks(static_cast<int64_t>(column->top) + 1);
+                hi.y = far;
+            }
+            empty = true;
+        }
+
+        if (block != 0) {
+            result.hit = true;
+            result.position = cell;
+            result.normal = normal;
+            result.distance = t;
+            result.block = block;
+            return result;
+        }
+
+        if (!empty) {
+            auto a = 0;
+            if (next[1] < next[a]) {
+                a = 1;
+            }
+            if (next[2] < next[a]) {
+                a = 2;
+            }
+
+            t = next[a];
+            cell[a] += step[a];
+            next[a] += delta[a];
+            normal = ivec3 { 0, 0, 0 };
+            normal[a] = -step[a];
+            continue;
+        }
+
+        // Leave the whole region at once through its nearest exit face
+        auto exit = infinity;
+        auto a = 0;
+        for (int32_t i = 0; i < 3; i++) {
+            if (step[i] == 0) {
+                continue;
+            }
+
+            const auto boundary = static_cast<float>(step[i] > 0 ? hi[i] : lo[i]);
+            const auto ti = (boundary - origin[i]) / direction[i];
+            if (ti < exit) {
+                exit = ti;
+                a = i;
+            }
+        }
+
+        t = std::max(t, exit);
+        for (int32_t i = 0; i < 3; i++) {
+            if (i == a) {
+                cell[i] = step[i] > 0 ? hi[i] : lo[i] - 1;
+            } else if (step[i] != 0) {
+                const auto c = static_cast<int32_t>(std::floor(origin[i] + direction[i] * t));
+                cell[i] = std::clamp(c, lo[i], hi[i] - 1);
+            }
+
+            if (step[i] != 0) {
+                next[i] = (static_cast<float>(cell[i] + (step[i] > 0 ? 1 : 0)) - origin[i]) / direction[i];
+            }
+        }
+
+        normal = ivec3 { 0, 0, 0 };
+        normal[a] = -step[a];
+    }
+
+    return result;
+}
+
+auto raycast(const World& world, const Ray& ray) -> RayHit {
+    RayCursor cursor;
+    return trace(world, cursor, ray);
+}
+
+auto raycast(const World& world, std::span<const Ray> rays, std::span<RayHit> hits) -> void {
+    RayCursor cursor;
+    for (size_t i = 0; i < std::size(rays); i++) {
+        hits[i] = trace(world, cursor, rays[i]);
+    }
+}
+
+auto has_line_of_sight(const World& world, const vec3& from, const vec3& to) -> bool {
+    const auto distance = glm::length(to - from);
+    if (distance == 0.0f) {
+        return true;
+    }
+
+    const auto hit = raycast(world, { .origin = from, .direction = to - from, .max_distance = distance });
+    return !hit.hit || hit.distance >= distance;
+}
+
+auto pick_block(const World& world, float reach) -> RayHit {
+    return raycast(world, { .origin = world._camera._position, .direction = world._camera._direction, .max_distance = reach });
+}
+
+} // namespace Game
\ No newline at end of file
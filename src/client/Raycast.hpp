@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Math.hpp"
+
+#include <span>
+
+namespace Game {
+
+struct World;
+
+// Block (x, y, z) is rendered as a unit cube centred on (x, y, z) in world space.
+struct Ray {
+    vec3 origin = vec3 { 0, 0, 0 };
+    vec3 direction = vec3 { 0, 0, -1 };
+    float max_distance = 64.0f;
+};
+
+struct RayHit {
+    bool hit = false;
+    ivec3 position = ivec3 { 0, 0, 0 };
+    ivec3 normal = ivec3 { 0, 0, 0 }; // zero when the ray starts inside a block
+    float distance = 0.0f;
+    uint32_t block = 0;
+};
+
+auto raycast(const World& world, const Ray& ray) -> RayHit;
+
+// Answers a batch of rays; hits must be at least as large as rays. Only reads the
+// world, so large batches can be split across threads by the caller.
+auto raycast(const World& world, std::span<const Ray> rays, std::span<RayHit> hits) -> void;
+
+auto has_line_of_sight(const World& world, const vec3& from, const vec3& to) -> bool;
+
+// Block under the camera's crosshair, within reach.
+auto pick_block(const World& world, float reach) -> RayHit;
+
+} // namespace Game
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "Renderer.hpp"
+#include "World.hpp"
 
 namespace Game {
 
@@ -6,6 +7,7 @@ auto create_renderer([[maybe_unused]] const CreateRendererInfo& info) -> Rendere
     Renderer renderer;
     renderer._block_types = info.block_types;
     renderer._texture_atlas = info.texture_atlas;
+    renderer._aspect = info.aspect;
 
     return renderer;
 }
@@ -13,7 +15,10 @@ auto create_renderer([[maybe_unused]] const CreateRendererInfo& info) -> Rendere
 auto destroy_renderer([[maybe_unused]] Renderer& renderer) -> void {
 }
 
-auto present([[maybe_unused]] Renderer& renderer, [[maybe_unused]] World& world) -> void {
+auto present(Renderer& renderer, World& world) -> void {
+    auto& camera = world._camera;
+    update_camera(camera, renderer._aspect);
+    get_visible_chunks(world, get_frustum(camera._projection * camera._view), renderer._visible);
 }
 
 } // namespace Game
\ No newline at end of file
@@ -3,24 +3,31 @@
 #include "Block.hpp"
 #include "TextureAtlas.hpp"
 
+#include <vector>
+
 namespace Game {
 
 struct World;
+struct Chunk;
 
 struct Renderer {
     BlockTypes _block_types;
     Graphics::TextureAtlas _texture_atlas;
+    float _aspect = 16.0f / 9.0f;
+    std::vector<const Chunk*> _visible; // chunks drawn this frame, after culling
 };
 
 struct CreateRendererInfo {
     BlockTypes block_types;
     Graphics::TextureAtlas texture_atlas;
+    float aspect = 16.0f / 9.0f; // of the window
 };
 
 auto create_renderer(const CreateRendererInfo& info) -> Renderer;
 
 auto destroy_renderer(Renderer& renderer) -> void;
 
+// Updates the camera matrices and culls the chunks against its frustum.
 auto present(Renderer& renderer, World& world) -> void;
 
 } // namespace Game
\ No newline at end of file
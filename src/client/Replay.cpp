@@ -0,0 +1,258 @@
+#include "Replay.hpp"
+#include "Content.hpp"
+#include "Journal.hpp"
+#include "Streaming.hpp"
+#include "Tags.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+
+namespace Application {
+
+using Content::ByteBuffer;
+using Content::read_value;
+using Content::write_value;
+
+static constexpr uint32_t RecordingMagic = 0x594c5052; // "RPLY"
+static constexpr uint16_t RecordingVersion = 1;
+
+static constexpr uint8_t HasPosition = 1 << 7;
+
+static constexpr float DtStep = 1e-5f; // seconds
+static constexpr float AngleScale = 32767.0f / std::numbers::pi_v<float>;
+
+static auto pack_input(const Input& input) -> uint8_t {
+    uint8_t bits = 0;
+    bits |= input.forward ? 1 << 0 : 0;
+    bits |= input.backward ? 1 << 1 : 0;
+    bits |= input.right ? 1 << 2 : 0;
+    bits |= input.left ? 1 << 3 : 0;
+    bits |= input.button_left ? 1 << 4 : 0;
+    bits |= input.button_right ? 1 << 5 : 0;
+    bits |= input.jump ? 1 << 6 : 0;
+    return bits;
+}
+
+static auto unpack_input(uint8_t bits) -> Input {
+    Input input;
+    input.forward = (bits & (1 << 0)) != 0;
+    input.backward = (bits & (1 << 1)) != 0;
+    input.right = (bits & (1 << 2)) != 0;
+    input.left = (bits & (1 << 3)) != 0;
+    input.button_left = (bits & (1 << 4)) != 0;
+    input.button_right = (bits & (1 << 5)) != 0;
+    input.jump = (bits & (1 << 6)) != 0;
+    return input;
+}
+
+static auto to_angle(float radians) -> int16_t {
+    return static_cast<int16_t>(std::clamp(std::round(radians * AngleScale), -32767.0f, 32767.0f));
+}
+
+static auto from_angles(int16_t yaw, int16_t pitch) -> vec3 {
+    const auto y = static_cast<float>(yaw) / AngleScale;
+    const auto p = static_cast<float>(pitch) / AngleScale;
+    return vec3 { std::sin(y) * std::cos(p), std::sin(p), -std::cos(y) * std::cos(p) };
+}
+
+auto save_recording(std::string_view filepath, std::span<const ReplayFrame> frames) -> bool {
+    ByteBuffer buf;
+    buf.reserve(10 + std::size(frames) * 7);
+
+    write_value(buf, RecordingMagic);
+    write_value(buf, RecordingVersion);
+    write_value(buf, static_cast<uint32_t>(std::size(frames)));
+
+    for (const auto& frame : frames) {
+        const auto direction = glm::length(frame.direction) > 0.0f ? glm::normalize(frame.direction) : vec3 { 0, 0, -1 };
+
+        write_value(buf, static_cast<uint8_t>(pack_input(frame.input) | (frame.position ? HasPosition : 0)));
+        write_value(buf, static_cast<uint16_t>(std::clamp(std::round(frame.dt / DtStep), 0.0f, 65535.0f)));
+        write_value(buf, to_angle(std::atan2(direction.x, -direction.z)));
+        write_value(buf, to_angle(std::asin(std::clamp(direction.y, -1.0f, 1.0f))));
+
+        if (frame.position) {
+            write_value(buf, frame.position->x);
+            write_value(buf, frame.position->y);
+            write_value(buf, frame.position->z);
+        }
+    }
+
+    return Content::write(filepath, std::string_view { reinterpret_cast<const char*>(std::data(buf)), std::size(buf) });
+}
+
+auto load_recording(std::string_view filepath) -> std::optional<ReplayFrames> {
+    const auto content = Content::read<ByteBuffer>(filepath);
+    if (!content) {
+        return std::nullopt;
+    }
+
+    std::span<const uint8_t> data = *content;
+
+    uint32_t magic = 0, count = 0;
+    uint16_t version = 0;
+    if (!read_value(data, magic) || magic != RecordingMagic || !read_value(data, version) || version != RecordingVersion || !read_value(data, count)) {
+        Journal::error(Tags::App, "'{}' is not a recording", filepath);
+        return std::nullopt;
+    }
+
+    ReplayFrames frames(count);
+    for (auto& frame : frames) {
+        uint8_t bits = 0;
+        uint16_t dt = 0;
+        int16_t yaw = 0, pitch = 0;
+        if (!read_value(data, bits) || !read_value(data, dt) || !read_value(data, yaw) || !read_value(data, pitch)) {
+            Journal::error(Tags::App, "Recording '{}' is truncated", filepath);
+            return std::nullopt;
+        }
+
+        frame.dt = static_cast<float>(dt) * DtStep;
+        frame.input = unpack_input(bits);
+        frame.direction = from_angles(yaw, pitch);
+
+        if (bits & HasPosition) {
+            vec3 position;
+            if (!read_value(data, position.x) || !read_value(data, position.y) || !read_value(data, position.z)) {
+                Journal::error(Tags::App, "Recording '{}' is truncated", filepath);
+                return std::nullopt;
+            }
+            frame.position = position;
+        }
+    }
+
+    return frames;
+}
+
+auto parse_replay_path(std::string_view name) -> std::optional<ReplayPath> {
+    if (name == "sprint") {
+        return ReplayPath::Sprint;
+    }
+    if (name == "spiral") {
+        return ReplayPath::Spiral;
+    }
+    if (name == "teleports") {
+        return ReplayPath::TeleportStorm;
+    }
+
+    return std::nullopt;
+}
+
+auto make_replay_path(ReplayPath path, size_t frames, float dt) -> ReplayFrames {
+    constexpr auto Altitude = 24.0f; // above the terrain under the camera
+    constexpr auto SprintSpeed = 32.0f; // blocks per second
+    constexpr auto TeleportRange = 1u << 14; // blocks around the origin
+
+    const auto above_terrain = [](float x, float z) {
+        const auto ground = Game::get_terrain_height({ static_cast<int32_t>(std::floor(x)), static_cast<int32_t>(std::floor(z)) });
+        return vec3 { x, static_cast<float>(ground) + Altitude, z };
+    };
+
+    ReplayFrames result(frames);
+
+    // Fixed seed LCG so every storm visits the same places
+    uint32_t seed = 0x2545f491u;
+    auto jump = vec3 { 0.0f };
+
+    for (size_t i = 0; i < frames; i++) {
+        auto& frame = result[i];
+        const auto t = static_cast<float>(i) * dt;
+        frame.dt = dt;
+
+        switch (path) {
+        case ReplayPath::Sprint:
+            frame.position = above_terrain(t * SprintSpeed, 0.0f);
+            frame.direction = vec3 { 1, 0, 0 };
+            break;
+        case ReplayPath::Spiral: {
+            const auto angle = t * 0.5f;
+            const auto radius = 32.0f + 12.0f * t;
+            frame.position = above_terrain(std::cos(angle) * radius, std::sin(angle) * radius);
+            frame.direction = vec3 { -std::sin(angle), 0, std::cos(angle) };
+            break;
+        }
+        case ReplayPath::TeleportStorm:
+            if (i % static_cast<size_t>(std::max(1.0f, std::round(1.0f / dt))) == 0) {
+                seed = seed * 1664525u + 1013904223u;
+                const auto x = static_cast<float>(seed % TeleportRange) - static_cast<float>(TeleportRange / 2);
+                seed = seed * 1664525u + 1013904223u;
+                const auto z = static_cast<float>(seed % TeleportRange) - static_cast<float>(TeleportRange / 2);
+                jump = above_terrain(x, z);
+            }
+            frame.position = jump;
+            frame.direction = vec3 { std::cos(t), -0.3f, std::sin(t) };
+            break;
+        }
+    }
+
+    return result;
+}
+
+static auto drop_body(Game::Body& body, const vec3& center, uint32_t index) -> void {
+    // Spread on a golden angle spiral, the same on every run
+    const auto angle = static_cast<float>(index) * 2.39996f;
+    const auto radius = 4.0f + std::sqrt(static_cast<float>(index)) * 1.5f;
+
+    body.position = center + vec3 { std::cos(angle) * radius, 8.0f + static_cast<float>(index % 7), std::sin(angle) * radius };
+    body.velocity = vec3 { std::sin(angle * 3.0f) * 2.0f, 0.0f, std::cos(angle * 5.0f) * 2.0f };
+}
+
+auto spawn_bodies(std::span<Game::Body> bodies, const vec3& center) -> void {
+    for (size_t i = 0; i < std::size(bodies); i++) {
+        drop_body(bodies[i], center, static_cast<uint32_t>(i));
+    }
+}
+
+auto step_bodies(const Game::World& world, std::span<Game::Body> bodies, const vec3& center, float gravity, float dt) -> size_t {
+    constexpr auto Range = 48.0f;
+
+    for (size_t i = 0; i < std::size(bodies); i++) {
+        auto& body = bodies[i];
+        const auto offset = body.position - center;
+        if (std::abs(offset.x) > Range || std::abs(offset.z) > Range || offset.y < -Range) {
+            drop_body(body, center, static_cast<uint32_t>(i));
+        }
+
+        body.velocity.y -= gravity * dt;
+    }
+
+    return Game::move_bodies(world, bodies, dt);
+}
+
+auto get_percentiles(std::vector<float> samples) -> Percentiles {
+    Percentiles result;
+    if (samples.empty()) {
+        return result;
+    }
+
+    std::sort(std::begin(samples), std::end(samples));
+
+    const auto rank = [&samples](float p) {
+        const auto index = static_cast<size_t>(std::ceil(p * static_cast<float>(std::size(samples))));
+        return samples[std::clamp<size_t>(index, 1, std::size(samples)) - 1];
+    };
+
+    result.p50 = rank(0.5f);
+    result.p90 = rank(0.9f);
+    result.p99 = rank(0.99f);
+    result.max = samples.back();
+
+    return result;
+}
+
+auto log_replay_report(const ReplayReport& report) -> void {
+    const auto& frame = report.frame_time;
+    const auto& load = report.load_latency;
+
+    Journal::message(Tags::App, "Replay of {} frames, frame time p50 {:.2f} p90 {:.2f} p99 {:.2f} max {:.2f} ms", report.frames, frame.p50, frame.p90,
+        frame.p99, frame.max);
+    Journal::message(Tags::App, "Columns loaded {} unloaded {}, load latency p50 {:.1f} p90 {:.1f} p99 {:.1f} max {:.1f} ms", report.columns_loaded,
+        report.columns_unloaded, load.p50, load.p90, load.p99, load.max);
+    Journal::message(Tags::App, "{} bodies, move_bodies p50 {:.3f} p90 {:.3f} p99 {:.3f} max {:.3f} ms", report.bodies, report.body_time.p50,
+        report.body_time.p90, report.body_time.p99, report.body_time.max);
+    Journal::message(Tags::App, "Meshing backlog peak {} chunks, {} left at the end", report.backlog_peak, report.backlog_end);
+    Journal::message(Tags::App, "Chunks per LOD {}, triangles per LOD {}", report.lod.chunks, report.lod.triangles);
+}
+
+} // namespace Application
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Collision.hpp"
+#include "Lod.hpp"
+#include "Math.hpp"
+#include "Window.hpp"
+
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Application {
+
+struct ReplayFrame {
+    float dt = 0.0f; // seconds the frame advances the world by
+    Input input;
+    vec3 direction = vec3 { 0, 0, -1 }; // of the camera
+    std::optional<vec3> position; // player position at the start of the frame, set by teleports and flythroughs; input moves it from there
+};
+
+using ReplayFrames = std::vector<ReplayFrame>;
+
+enum class ReplayPath : uint8_t {
+    Sprint, // straight line above the terrain, a new row of columns every few seconds
+    Spiral, // widening spiral, loads and unloads on every side
+    TeleportStorm, // a far jump every second, nothing loaded stays useful
+};
+
+struct Percentiles {
+    float p50 = 0.0f;
+    float p90 = 0.0f;
+    float p99 = 0.0f;
+    float max = 0.0f;
+};
+
+struct ReplayReport {
+    size_t frames = 0;
+    Percentiles frame_time; // milliseconds
+    Percentiles load_latency; // milliseconds from a column entering the view distance until it is fully meshed
+    size_t bodies = 0;
+    Percentiles body_time; // milliseconds per frame in move_bodies
+    size_t columns_loaded = 0;
+    size_t columns_unloaded = 0;
+    size_t backlog_peak = 0; // chunks waiting for a mesh
+    size_t backlog_end = 0;
+    Game::LodStats lod; // chunks and triangles per level at the end of the run
+};
+
+// Seven bytes per frame: input bits, dt in 10 microsecond steps and the camera's yaw and
+// pitch as 16 bit angles. Frames with a position add it as three floats.
+auto save_recording(std::string_view filepath, std::span<const ReplayFrame> frames) -> bool;
+auto load_recording(std::string_view filepath) -> std::optional<ReplayFrames>;
+
+// "sprint", "spiral" or "teleports"
+auto parse_replay_path(std::string_view name) -> std::optional<ReplayPath>;
+// Scripted paths set the position every frame and are the same on every run.
+auto make_replay_path(ReplayPath path, size_t frames, float dt) -> ReplayFrames;
+
+// Falling boxes kept within range of center to load the collision code during replays:
+// bodies that wander off or fall out of the world are dropped back in around center.
+auto spawn_bodies(std::span<Game::Body> bodies, const vec3& center) -> void;
+auto step_bodies(const Game::World& world, std::span<Game::Body> bodies, const vec3& center, float gravity, float dt) -> size_t;
+
+// Nearest rank; samples are taken by value because they get sorted.
+auto get_percentiles(std::vector<float> samples) -> Percentiles;
+auto log_replay_report(const ReplayReport& report) -> void;
+
+} // namespace Application
\ No newline at end of file
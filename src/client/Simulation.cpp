@@ -0,0 +1,303 @@
+#include "Simulation.hpp"
+#include "World.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_set>
+#include <utility>
+
+namespace Game {
+
+static const ivec3 Sides[] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+static const ivec3 Up = ivec3 { 0, 1, 0 };
+
+static auto activate(Simulation& simulation, const ivec3& position) -> void {
+    const auto chunk_position = world_to_chunk(position);
+    const auto key = chunk_key(chunk_position);
+
+    auto [it, inserted] = simulation._active.try_emplace(key);
+    if (inserted) {
+        it->second._position = chunk_position;
+        simulation._queue.push_back(key);
+    }
+
+    const auto local = world_to_local(position);
+    const auto cell = ((local.y % Chunk::SectionSize) * Chunk::Size + local.x) * Chunk::Size + local.z;
+    it->second._sections[local.y / Chunk::SectionSize].push_back(static_cast<uint16_t>(cell));
+}
+
+struct SimulationCursor {
+    const Chunk* chunk = nullptr;
+    ivec3 chunk_position = ivec3 { 0, 0, 0 };
+    bool cached = false;
+};
+
+// Reads are made against the world as it was at the start of the tick; writes are
+// collected and claimed so two rules never write the same cell in one tick.
+struct TickContext {
+    const World& world;
+    const Simulation& simulation;
+    const BlockTypes& block_types;
+    const SimulationSettings& settings;
+
+    SimulationCursor cursor = {};
+    std::vector<BlockEdit> edits = {};
+    std::vector<std::pair<ivec3, uint8_t>> levels = {};
+    std::vector<ivec3> wake = {};
+    std::unordered_set<uint64_t> claimed = {};
+};
+
+// Blocks in unloaded chunks can be read but never written, so loaded is reported.
+static auto read_block(TickContext& context, const ivec3& position, bool& loaded) -> uint32_t {
+    auto& cursor = context.cursor;
+    const auto chunk_position = world_to_chunk(position);
+    if (!cursor.cached || cursor.chunk_position != chunk_position) {
+        cursor.chunk = find_chunk(context.world, chunk_position);
+        cursor.chunk_position = chunk_position;
+        cursor.cached = true;
+    }
+
+    loaded = cursor.chunk != nullptr;
+    if (!loaded) {
+        return get_block(context.world, position);
+    }
+
+    const auto local = world_to_local(position);
+    return cursor.chunk->_blocks[local.y][local.x][local.z];
+}
+
+static auto get_behaviour(const TickContext& context, uint32_t block) -> BlockBehaviour {
+    return block < std::size(context.block_types) ? context.block_types[block].behaviour : BlockBehaviour::Static;
+}
+
+static auto get_level(const TickContext& context, const ivec3& position) -> uint8_t {
+    const auto it = context.simulation._fluid_levels.find(block_key(position));
+    return it != std::end(context.simulation._fluid_levels) ? it->second : 0;
+}
+
+static auto claim(TickContext& context, const ivec3& position) -> bool {
+    return context.claimed.insert(block_key(position)).second;
+}
+
+static auto is_claimed(const TickContext& context, const ivec3& position) -> bool {
+    return context.claimed.contains(block_key(position));
+}
+
+static auto tick_falling(TickContext& context, const ivec3& position, uint32_t block) -> void {
+    const auto below = position - Up;
+
+    bool loaded = false;
+    const auto displaced = read_block(context, below, loaded);
+    if (!loaded || (displaced != 0 && get_behaviour(context, displaced) != BlockBehaviour::Fluid)) {
+        return;
+    }
+
+    if (is_claimed(context, position) || is_claimed(context, below)) {
+        return;
+    }
+
+    claim(context, position);
+    claim(context, below);
+
+    // Swap places with the air or fluid underneath
+    context.edits.push_back({ .position = below, .block = block });
+    context.edits.push_back({ .position = position, .block = displaced });
+    if (displaced != 0) {
+        context.levels.emplace_back(position, get_level(context, below));
+    }
+}
+
+static auto tick_fluid(TickContext& context, const ivec3& position, uint32_t block) -> void {
+    auto level = get_level(context, position);
+    bool loaded = false;
+
+    // Flowing cells follow their supply: fed from above, or one step further than
+    // the closest fed neighbour. Without either they dry up.
+    if (level > 0) {
+        auto expected = std::numeric_limits<uint32_t>::max();
+        if (read_block(context, position + Up, loaded) == block) {
+            expected = 1;
+        } else {
+            for (const auto& side : Sides) {
+                if (read_block(context, position + side, loaded) == block) {
+                    expected = std::min(expected, get_level(context, position + side) + 1u);
+                }
+            }
+        }
+
+        if (expected > context.settings.fluid_spread) {
+            if (claim(context, position)) {
+                context.edits.push_back({ .position = position, .block = 0 });
+            }
+            return;
+        }
+
+        if (expected != level) {
+            level = static_cast<uint8_t>(expected);
+            context.levels.emplace_back(position, level);
+            context.wake.push_back(position);
+        }
+    }
+
+    const auto below = read_block(context, position - Up, loaded);
+    if (below == 0) {
+        if (loaded && claim(context, position - Up)) {
+            context.edits.push_back({ .position = position - Up, .block = block });
+            context.levels.emplace_back(position - Up, uint8_t { 1 });
+        }
+        return;
+    }
+
+    // Only spread sideways when resting on something solid
+    if (get_behaviour(context, below) == BlockBehaviour::Fluid || level >= context.settings.fluid_spread) {
+        return;
+    }
+
+    for (const auto& side : Sides) {
+        const auto neighbour = position + side;
+        if (read_block(context, neighbour, loaded) == 0 && loaded && claim(context, neighbour)) {
+            context.edits.push_back({ .position = neighbour, .block = block });
+            context.levels.emplace_back(neighbour, static_cast<uint8_t>(level + 1));
+        }
+    }
+}
+
+static auto tick_cell(TickContext& context, const ivec3& position) -> void {
+    bool loaded = false;
+    const auto block = read_block(context, position, loaded);
+    if (!loaded || block == 0) {
+        return;
+    }
+
+    switch (get_behaviour(context, block)) {
+    case BlockBehaviour::Falling:
+        tick_falling(context, position, block);
+        break;
+    case BlockBehaviour::Fluid:
+        tick_fluid(context, position, block);
+        break;
+    case BlockBehaviour::Static:
+        break;
+    }
+}
+
+auto schedule_block(Simulation& simulation, const ivec3& position) -> void {
+    activate(simulation, position);
+    activate(simulation, position + Up);
+    activate(simulation, position - Up);
+    for (const auto& side : Sides) {
+        activate(simulation, position + side);
+    }
+}
+
+auto schedule_changes(Simulation& simulation, std::span<const BlockChange> changes) -> void {
+    for (const auto& change : changes) {
+        // Whatever replaced a flowing cell starts out as a source
+        simulation._fluid_levels.erase(block_key(change.position));
+        schedule_block(simulation, change.position);
+    }
+}
+
+auto schedule_chunk(Simulation& simulation, const Chunk& chunk, const BlockTypes& block_types) -> size_t {
+    const auto is_dynamic = [&block_types](uint32_t block) {
+        return block < std::size(block_types) && block_types[block].behaviour != BlockBehaviour::Static;
+    };
+
+    if (std::none_of(std::begin(block_types), std::end(block_types), [](const auto& type) { return type.behaviour != BlockBehaviour::Static; })) {
+        return 0;
+    }
+
+    const auto origin = chunk_origin(chunk._position);
+    size_t woken = 0;
+
+    for (size_t s = 0; s < Chunk::SectionCount; s++) {
+        const auto& section = chunk._sections[s];
+        if (is_section_empty(section) || (section._uniform && !is_dynamic(section._block))) {
+            continue;
+        }
+
+        for (auto y = s * Chunk::SectionSize; y < (s + 1) * Chunk::SectionSize; y++) {
+            for (size_t x = 0; x < Chunk::Size; x++) {
+                for (size_t z = 0; z < Chunk::Size; z++) {
+                    if (is_dynamic(chunk._blocks[y][x][z])) {
+                        activate(simulation, origin + ivec3 { static_cast<int32_t>(x), static_cast<int32_t>(y), static_cast<int32_t>(z) });
+                        woken++;
+                    }
+                }
+            }
+        }
+    }
+
+    return woken;
+}
+
+auto step_simulation(World& world, Simulation& simulation, const BlockTypes& block_types, const SimulationSettings& settings)
+    -> SimulationStats {
+    SimulationStats stats;
+
+    auto active = std::exchange(simulation._active, {});
+    auto queue = std::exchange(simulation._queue, {});
+
+    TickContext context { world, simulation, block_types, settings };
+
+    for (const auto key : queue) {
+        auto& chunk = active[key];
+        const auto origin = chunk_origin(chunk._position);
+
+        for (size_t s = 0; s < Chunk::SectionCount; s++) {
+            auto& cells = chunk._sections[s];
+            std::sort(std::begin(cells), std::end(cells));
+            cells.erase(std::unique(std::begin(cells), std::end(cells)), std::end(cells));
+
+            size_t done = 0;
+            for (; done < std::size(cells) && stats.ticked < settings.tick_budget; done++) {
+                const auto cell = static_cast<int32_t>(cells[done]);
+                const auto size = static_cast<int32_t>(Chunk::Size);
+                const auto y = static_cast<int32_t>(s * Chunk::SectionSize) + cell / (size * size);
+                tick_cell(context, origin + ivec3 { (cell / size) % size, y, cell % size });
+                stats.ticked++;
+            }
+            cells.erase(std::begin(cells), std::begin(cells) + static_cast<std::ptrdiff_t>(done));
+        }
+
+        // Spill-over keeps its place at the front of the queue
+        const auto left = std::any_of(std::begin(chunk._sections), std::end(chunk._sections), [](const auto& cells) { return !cells.empty(); });
+        if (left) {
+            simulation._queue.push_back(key);
+            simulation._active.emplace(key, std::move(chunk));
+        }
+    }
+
+    // apply_edits schedules the neighbourhoods of what changed
+    stats.changed = apply_edits(world, block_types, context.edits);
+
+    for (const auto& [position, level] : context.levels) {
+        if (level == 0) {
+            simulation._fluid_levels.erase(block_key(position));
+        } else {
+            simulation._fluid_levels[block_key(position)] = level;
+        }
+    }
+
+    for (const auto& position : context.wake) {
+        schedule_block(simulation, position);
+    }
+
+    stats.pending = get_pending_cells(simulation);
+    simulation._tick++;
+
+    return stats;
+}
+
+auto get_pending_cells(const Simulation& simulation) -> size_t {
+    size_t pending = 0;
+    for (const auto& [key, chunk] : simulation._active) {
+        for (const auto& cells : chunk._sections) {
+            pending += std::size(cells);
+        }
+    }
+
+    return pending;
+}
+
+} // namespace Game
\ No newline at end of file
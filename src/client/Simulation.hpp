@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Block.hpp"
+#include "Chunk.hpp"
+#include "Edit.hpp"
+#include "Math.hpp"
+
+#include <array>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace Game {
+
+struct World;
+
+// Cells waiting for a tick, one set per section. A cell is its offset inside the
+// section, (y * Size + x) * Size + z with y relative to the section bottom.
+struct ActiveChunk {
+    ivec3 _position = ivec3 { 0, 0, 0 };
+    std::array<std::vector<uint16_t>, Chunk::SectionCount> _sections;
+};
+
+struct Simulation {
+    std::unordered_map<uint64_t, ActiveChunk> _active;
+    std::vector<uint64_t> _queue; // keys of _active, oldest first
+    std::unordered_map<uint64_t, uint8_t> _fluid_levels; // distance to the source of flowing cells; sources have no entry
+    uint64_t _tick = 0;
+};
+
+struct SimulationSettings {
+    size_t tick_budget = 4096; // cells per tick, the rest spill over to the next one
+    uint8_t fluid_spread = 7; // furthest a fluid flows sideways from its source
+};
+
+struct SimulationStats {
+    size_t ticked = 0;
+    size_t changed = 0;
+    size_t pending = 0; // cells carried over to the next tick
+};
+
+// Wakes the cell and its six neighbours.
+auto schedule_block(Simulation& simulation, const ivec3& position) -> void;
+auto schedule_changes(Simulation& simulation, std::span<const BlockChange> changes) -> void;
+// Wakes the fluids and falling blocks of a chunk that was just added or whose block
+// types changed, skipping sections that are air or uniformly static. Returns the cells woken.
+auto schedule_chunk(Simulation& simulation, const Chunk& chunk, const BlockTypes& block_types) -> size_t;
+
+// Ticks the active cells up to the budget, applies the resulting edits as one batch
+// and schedules their neighbourhoods for the next tick. Cost depends only on the
+// number of active cells.
+auto step_simulation(World& world, Simulation& simulation, const BlockTypes& block_types, const SimulationSettings& settings) -> SimulationStats;
+
+auto get_pending_cells(const Simulation& simulation) -> size_t;
+
+} // namespace Game
\ No newline at end of file
@@ -1 +1,173 @@
-#include "Storage.hpp"
\ No newline at end of file
+#include "Storage.hpp"
+#include "Content.hpp"
+#include "Journal.hpp"
+#include "Tags.hpp"
+#include "World.hpp"
+
+#include <cstring>
+#include <memory>
+
+namespace Game {
+
+using Content::read_value;
+using Content::write_value;
+
+static constexpr uint32_t ChunkMagic = 0x4b4e4843; // "CHNK"
+static constexpr uint32_t ColumnMagic = 0x4d4c4f43; // "COLM"
+
+static constexpr uint8_t UniformSection = 0;
+static constexpr uint8_t RawSection = 1;
+
+auto save_chunk(const Chunk& chunk) -> ByteBuffer {
+    ByteBuffer buf;
+
+    write_value(buf, ChunkMagic);
+    write_value(buf, static_cast<int32_t>(chunk._position.x));
+    write_value(buf, static_cast<int32_t>(chunk._position.y));
+    write_value(buf, static_cast<int32_t>(chunk._position.z));
+
+    for (size_t s = 0; s < Chunk::SectionCount; s++) {
+        const auto& section = chunk._sections[s];
+
+        if (section._uniform) {
+            write_value(buf, UniformSection);
+            write_value(buf, section._block);
+            continue;
+        }
+
+        write_value(buf, RawSection);
+
+        const auto bytes = Chunk::SectionVolume * sizeof(uint32_t);
+        const auto offset = std::size(buf);
+        buf.resize(offset + bytes);
+        memcpy(std::data(buf) + offset, &chunk._blocks[s * Chunk::SectionSize][0][0], bytes);
+    }
+
+    return buf;
+}
+
+auto load_chunk(std::span<const uint8_t> data, Chunk& chunk) -> bool {
+    uint32_t magic = 0;
+    int32_t x = 0, y = 0, z = 0;
+    if (!read_value(data, magic) || magic != ChunkMagic || !read_value(data, x) || !read_value(data, y) || !read_value(data, z)) {
+        Journal::error(Tags::Game, "{}", "Invalid chunk header");
+        return false;
+    }
+
+    chunk = create_chunk(ivec3 { x, y, z });
+
+    for (size_t s = 0; s < Chunk::SectionCount; s++) {
+        const auto y_begin = s * Chunk::SectionSize;
+
+        uint8_t kind = 0;
+        if (!read_value(data, kind)) {
+            Journal::error(Tags::Game, "Chunk {} {} {} truncated at section {}", x, y, z, s);
+            return false;
+        }
+
+        if (kind == UniformSection) {
+            uint32_t block = 0;
+            if (!read_value(data, block)) {
+                Journal::error(Tags::Game, "Chunk {} {} {} truncated at section {}", x, y, z, s);
+                return false;
+            }
+
+            fill_chunk(chunk, y_begin, y_begin + Chunk::SectionSize, block);
+            continue;
+        }
+
+        const auto bytes = Chunk::SectionVolume * sizeof(uint32_t);
+        if (kind != RawSection || std::size(data) < bytes) {
+            Journal::error(Tags::Game, "Chunk {} {} {} has corrupted section {}", x, y, z, s);
+            return false;
+        }
+
+        memcpy(&chunk._blocks[y_begin][0][0], std::data(data), bytes);
+        data = data.subspan(bytes);
+
+        update_chunk_section(chunk, s);
+    }
+
+    return true;
+}
+
+auto save_column(World& world, const ivec2& position) -> ByteBuffer {
+    ByteBuffer buf;
+
+    const auto column = find_column(world, position);
+    if (!column) {
+        return buf;
+    }
+
+    // Compacted chunks are written in full, expanded into a scratch chunk
+    std::unique_ptr<Chunk> scratch;
+    std::vector<ByteBuffer> chunks;
+
+    for (auto y = column->top; (column->chunks > 0 || column->far > 0) && y >= column->bottom; y--) {
+        const auto chunk_position = ivec3 { position.x, y, position.y };
+        if (const auto chunk = find_chunk(world, chunk_position); chunk) {
+            chunks.push_back(save_chunk(*chunk));
+            chunk->_unsaved_sections = 0;
+        } else if (const auto it = world._far_chunks.find(chunk_key(chunk_position)); it != std::end(world._far_chunks)) {
+            if (!scratch) {
+                scratch = std::make_unique<Chunk>();
+            }
+
+            expand_octree(it->second, *scratch);
+            scratch->_position = chunk_position;
+            chunks.push_back(save_chunk(*scratch));
+            it->second._unsaved_sections = 0;
+        }
+    }
+
+    write_value(buf, ColumnMagic);
+    write_value(buf, static_cast<int32_t>(position.x));
+    write_value(buf, static_cast<int32_t>(position.y));
+    write_value(buf, static_cast<int32_t>(column->bottom));
+    write_value(buf, column->fill);
+    write_value(buf, static_cast<uint32_t>(std::size(chunks)));
+
+    for (const auto& data : chunks) {
+        write_value(buf, static_cast<uint32_t>(std::size(data)));
+        buf.insert(std::end(buf), std::begin(data), std::end(data));
+    }
+
+    return buf;
+}
+
+auto load_column(World& world, const ivec2& position, std::span<const uint8_t> data) -> bool {
+    uint32_t magic = 0, fill = 0, count = 0;
+    int32_t x = 0, z = 0, bottom = 0;
+    if (!read_value(data, magic) || magic != ColumnMagic || !read_value(data, x) || !read_value(data, z) || !read_value(data, bottom)
+        || !read_value(data, fill) || !read_value(data, count) || x != position.x || z != position.y) {
+        Journal::error(Tags::Game, "Invalid column header for {} {}", position.x, position.y);
+        return false;
+    }
+
+    auto& column = world._columns[column_key(position)];
+    column.bottom = bottom;
+    column.fill = fill;
+
+    // Too large for the stack
+    const auto chunk = std::make_unique<Chunk>();
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t size = 0;
+        if (!read_value(data, size) || std::size(data) < size) {
+            Journal::error(Tags::Game, "Column {} {} truncated at chunk {}", position.x, position.y, i);
+            return false;
+        }
+
+        if (!load_chunk(data.first(size), *chunk)) {
+            return false;
+        }
+        data = data.subspan(size);
+
+        chunk->_dirty_sections = static_cast<uint8_t>((1u << Chunk::SectionCount) - 1);
+        add_chunk(world, std::move(*chunk));
+    }
+
+    return true;
+}
+
+} // namespace Game
\ No newline at end of file
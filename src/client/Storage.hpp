@@ -1,3 +1,26 @@
 #pragma once
 
-namespace Game { }
\ No newline at end of file
+#include "Chunk.hpp"
+#include "Content.hpp"
+#include "Math.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Game {
+
+struct World;
+
+using ByteBuffer = Content::ByteBuffer;
+
+// Uniform sections are stored as a single block id instead of their voxels.
+auto save_chunk(const Chunk& chunk) -> ByteBuffer;
+auto load_chunk(std::span<const uint8_t> data, Chunk& chunk) -> bool;
+
+// The column's bottom and fill followed by each loaded or compacted chunk. Clears their unsaved sections.
+auto save_column(World& world, const ivec2& column) -> ByteBuffer;
+// Adds the saved chunks unlit and flagged for meshing, as generate_column does.
+auto load_column(World& world, const ivec2& column, std::span<const uint8_t> data) -> bool;
+
+} // namespace Game
\ No newline at end of file
@@ -0,0 +1,254 @@
+#include "Streaming.hpp"
+#include "Content.hpp"
+#include "Journal.hpp"
+#include "Lighting.hpp"
+#include "Storage.hpp"
+#include "Tags.hpp"
+#include "World.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+
+namespace Game {
+
+static auto column_distance(const ivec2& a, const ivec2& b) -> int32_t {
+    return std::max(std::abs(a.x - b.x), std::abs(a.y - b.y));
+}
+
+static auto get_column_path(const StreamingSettings& settings, const ivec2& position) -> std::string {
+    return fmt::format("{}/{}_{}.column", settings.save_directory, position.x, position.y);
+}
+
+static auto is_column_unsaved(const World& world, const ivec2& position) -> bool {
+    const auto column = find_column(world, position);
+    if (!column) {
+        return false;
+    }
+
+    for (auto y = column->top; (column->chunks > 0 || column->far > 0) && y >= column->bottom; y--) {
+        const auto chunk = find_chunk(world, { position.x, y, position.y });
+        if (chunk && chunk->_unsaved_sections != 0) {
+            return true;
+        }
+
+        const auto it = world._far_chunks.find(chunk_key({ position.x, y, position.y }));
+        if (it != std::end(world._far_chunks) && it->second._unsaved_sections != 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static auto save_column_file(World& world, const StreamingSettings& settings, const ivec2& position) -> bool {
+    std::error_code error;
+    std::filesystem::create_directories(settings.save_directory, error);
+
+    const auto path = get_column_path(settings, position);
+    const auto buf = save_column(world, position);
+    if (!Content::write(path, std::string_view { reinterpret_cast<const char*>(std::data(buf)), std::size(buf) })) {
+        Journal::error(Tags::Game, "Failed to save column '{}'", path);
+        return false;
+    }
+
+    return true;
+}
+
+static auto unload_column(World& world, const ivec2& position) -> void {
+    const auto it = world._columns.find(column_key(position));
+    if (it == std::end(world._columns)) {
+        return;
+    }
+
+    const auto top = std::max(it->second.top, it->second.bottom);
+    const auto bottom = it->second.bottom;
+
+    for (auto y = top; y >= bottom && it->second.chunks > 0; y--) {
+        remove_chunk(world, { position.x, y, position.y });
+    }
+
+    // Chunks compacted to meet the memory budget go with the column
+    for (auto y = top; y >= bottom; y--) {
+        world._far_chunks.erase(chunk_key({ position.x, y, position.y }));
+    }
+
+    world._columns.erase(it);
+}
+
+static auto is_column_meshed(const World& world, const ivec2& position) -> bool {
+    const auto column = find_column(world, position);
+    if (!column || column->chunks == 0) {
+        return true;
+    }
+
+    for (auto y = column->top; y >= column->bottom; y--) {
+        const auto chunk = find_chunk(world, { position.x, y, position.y });
+        if (chunk && chunk->_dirty_sections != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto get_terrain_height(const ivec2& position) -> int32_t {
+    const auto x = static_cast<float>(position.x);
+    const auto z = static_cast<float>(position.y);
+    const auto height = 24.0f * std::sin(x * 0.011f) * std::cos(z * 0.013f) + 9.0f * std::sin((x + z) * 0.037f) + 3.0f * std::cos(x * 0.091f - z * 0.067f);
+
+    return 64 + static_cast<int32_t>(std::floor(height));
+}
+
+auto get_terrain_heights(const ivec2& column) -> std::vector<int32_t> {
+    std::vector<int32_t> heights(Chunk::Size * Chunk::Size);
+
+    const auto origin = column * static_cast<int32_t>(Chunk::Size);
+    for (size_t x = 0; x < Chunk::Size; x++) {
+        for (size_t z = 0; z < Chunk::Size; z++) {
+            heights[x * Chunk::Size + z] = get_terrain_height(origin + ivec2 { static_cast<int32_t>(x), static_cast<int32_t>(z) });
+        }
+    }
+
+    return heights;
+}
+
+auto update_streaming(World& world, Streamer& streamer, const BlockTypes& block_types, const StreamingSettings& settings, double now)
+    -> StreamingStats {
+    const auto camera = world_to_chunk(ivec3 { glm::floor(world._camera._position) });
+    const auto center = ivec2 { camera.x, camera.z };
+
+    StreamingStats stats;
+
+    // One column of slack so a camera on a border does not load and unload every frame
+    std::vector<ivec2> far;
+    for (const auto& [key, column] : world._columns) {
+        const auto position = ivec2 { static_cast<int32_t>(key >> 32), static_cast<int32_t>(key & 0xffffffffu) };
+        if (column_distance(position, center) > settings.view_distance + 1) {
+            far.push_back(position);
+        }
+    }
+
+    for (const auto& position : far) {
+        if (!settings.save_directory.empty() && is_column_unsaved(world, position)) {
+            save_column_file(world, settings, position);
+        }
+        unload_column(world, position);
+        streamer._columns.erase(column_key(position));
+        stats.unloaded++;
+    }
+
+    std::erase_if(streamer._columns, [&](const auto& entry) { return column_distance(entry.second._position, center) > settings.view_distance + 1; });
+
+    for (auto dx = -settings.view_distance; dx <= settings.view_distance; dx++) {
+        for (auto dz = -settings.view_distance; dz <= settings.view_distance; dz++) {
+            const auto position = center + ivec2 { dx, dz };
+            const auto key = column_key(position);
+            if (!world._columns.contains(key) && !streamer._columns.contains(key)) {
+                streamer._columns.emplace(key, StreamedColumn { ._position = position, ._requested = now });
+            }
+        }
+    }
+
+    // Nearest first, ties broken by position so runs are reproducible
+    std::vector<StreamedColumn*> waiting;
+    for (auto& [key, column] : streamer._columns) {
+        if (!column._generated) {
+            waiting.push_back(&column);
+        }
+    }
+
+    const auto count = std::min(settings.loads_per_update, std::size(waiting));
+    std::partial_sort(std::begin(waiting), std::begin(waiting) + static_cast<std::ptrdiff_t>(count), std::end(waiting), [&](const auto* a, const auto* b) {
+        const auto da = column_distance(a->_position, center);
+        const auto db = column_distance(b->_position, center);
+        return da != db ? da < db : column_key(a->_position) < column_key(b->_position);
+    });
+
+    for (size_t i = 0; i < count; i++) {
+        auto& column = *waiting[i];
+
+        auto loaded = false;
+        if (!settings.save_directory.empty()) {
+            if (const auto content = Content::read<ByteBuffer>(get_column_path(settings, column._position)); content) {
+                loaded = load_column(world, column._position, *content);
+            }
+        }
+
+        // A corrupted save leaves part of the column behind, regenerate all of it
+        if (!loaded) {
+            unload_column(world, column._position);
+            generate_column(world, column._position, get_terrain_heights(column._position), settings.layers);
+        }
+
+        const auto info = find_column(world, column._position);
+        for (auto y = info->top; info->chunks > 0 && y >= info->bottom; y--) {
+            if (const auto chunk = find_chunk(world, { column._position.x, y, column._position.y }); chunk) {
+                light_chunk(world, *chunk, block_types);
+                schedule_chunk(world._simulation, *chunk, block_types);
+            }
+        }
+
+        column._generated = true;
+        stats.loaded++;
+    }
+
+    // Compacted chunks come back nearest first, sharing the load budget
+    const auto half = static_cast<float>(Chunk::Size) * 0.5f;
+    std::vector<std::pair<float, ivec3>> nearby;
+    for (const auto& [key, octree] : world._far_chunks) {
+        const auto distance = glm::length(vec3 { chunk_origin(octree._position) } + vec3 { half } - world._camera._position);
+        if (distance < settings.expand_radius) {
+            nearby.emplace_back(distance, octree._position);
+        }
+    }
+
+    std::sort(std::begin(nearby), std::end(nearby), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (size_t i = 0; i < std::size(nearby) && stats.loaded + stats.expanded < settings.loads_per_update; i++) {
+        if (const auto chunk = expand_chunk(world, nearby[i].second); chunk) {
+            light_chunk(world, *chunk, block_types);
+            schedule_chunk(world._simulation, *chunk, block_types);
+            stats.expanded++;
+        }
+    }
+
+    stats.meshed = update_chunk_meshes(world, block_types, settings.meshes_per_update);
+
+    for (auto it = std::begin(streamer._columns); it != std::end(streamer._columns);) {
+        if (it->second._generated && is_column_meshed(world, it->second._position)) {
+            streamer._latencies.push_back(static_cast<float>(now - it->second._requested));
+            it = streamer._columns.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    stats.backlog = static_cast<size_t>(
+        std::count_if(std::begin(world._chunks), std::end(world._chunks), [](const auto& chunk) { return chunk->_dirty_sections != 0; }));
+
+    return stats;
+}
+
+auto save_columns(World& world, const StreamingSettings& settings) -> size_t {
+    if (settings.save_directory.empty()) {
+        return 0;
+    }
+
+    std::vector<ivec2> unsaved;
+    for (const auto& [key, column] : world._columns) {
+        const auto position = ivec2 { static_cast<int32_t>(key >> 32), static_cast<int32_t>(key & 0xffffffffu) };
+        if (is_column_unsaved(world, position)) {
+            unsaved.push_back(position);
+        }
+    }
+
+    size_t saved = 0;
+    for (const auto& position : unsaved) {
+        saved += save_column_file(world, settings, position) ? 1 : 0;
+    }
+
+    return saved;
+}
+
+} // namespace Game
\ No newline at end of file
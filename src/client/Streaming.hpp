@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Block.hpp"
+#include "Generator.hpp"
+#include "Math.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Game {
+
+struct World;
+
+struct StreamingSettings {
+    int32_t view_distance = 4; // columns kept loaded around the camera along x and z
+    size_t loads_per_update = 2; // columns generated and lit per update
+    size_t meshes_per_update = 16; // chunk meshes rebuilt per update
+    float expand_radius = 128.0f; // compacted chunks this close to the camera are expanded, run clamps it to MemoryBudget::keep_radius
+    TerrainLayers layers = { .surface = 1, .soil = 1, .stone = 2 }; // ids into the block types, 0 is air
+    std::string save_directory = "../saves"; // edited columns are saved there when unloaded, empty drops edits
+};
+
+// A column from the moment it enters the view distance until all of its chunks are meshed
+struct StreamedColumn {
+    ivec2 _position = ivec2 { 0, 0 };
+    double _requested = 0.0; // seconds
+    bool _generated = false;
+};
+
+struct Streamer {
+    std::unordered_map<uint64_t, StreamedColumn> _columns; // in flight, keyed by column_key
+    std::vector<float> _latencies; // seconds from request to meshed, per finished column
+};
+
+struct StreamingStats {
+    size_t loaded = 0;
+    size_t unloaded = 0;
+    size_t expanded = 0; // compacted chunks brought back to full detail
+    size_t meshed = 0;
+    size_t backlog = 0; // chunks still waiting for a mesh
+};
+
+// Rolling hills, the same for a column wherever and whenever it is generated
+auto get_terrain_height(const ivec2& position) -> int32_t;
+auto get_terrain_heights(const ivec2& column) -> std::vector<int32_t>;
+
+// Loads the nearest missing columns around the camera, from the save directory when they
+// were edited before, expands compacted chunks that came close again, unloads the columns
+// past the view distance, saving their edits, and meshes within the per update budgets.
+// now only timestamps requests.
+auto update_streaming(World& world, Streamer& streamer, const BlockTypes& block_types, const StreamingSettings& settings, double now)
+    -> StreamingStats;
+
+// Saves every loaded column with unsaved edits, returns how many were written.
+auto save_columns(World& world, const StreamingSettings& settings) -> size_t;
+
+} // namespace Game
\ No newline at end of file
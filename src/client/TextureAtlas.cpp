@@ -7,39 +7,50 @@
 
 namespace Graphics {
 
-using ByteBuffer = std::vector<uint8_t>;
-
-auto append_texture(TextureAtlas& atlas, std::string_view name, std::string_view filepath) -> bool {
+using Content::ByteBuffer;
 
+static auto load_texture(std::string_view name, std::string_view filepath) -> std::optional<TextureInfo> {
     auto content = Content::read<ByteBuffer>(filepath);
     if (!content) {
         Journal::error(Tags::Graphics, "Failed to load '{}'", filepath);
-        return false;
+        return std::nullopt;
     }
 
     auto image = ImageLoader::load_image({ .data = *content });
     if (!image) {
         Journal::error(Tags::Graphics, "Failed to read '{}'", name);
-        return false;
+        return std::nullopt;
     }
 
     TextureInfo texture_info;
     texture_info.width = image->width;
     texture_info.height = image->height;
     texture_info.channels = image->channels;
-    texture_info.pixels = image->pixels;
+    texture_info.pixels.assign(std::begin(image->pixels), std::end(image->pixels));
     texture_info.name = name;
     texture_info.filepath = filepath;
 
     Journal::debug(Tags::Graphics, "Image '{}' {}x{} {}", name, image->width, image->height, image->channels * 8);
 
-    atlas._textures.push_back(texture_info);
+    return texture_info;
+}
+
+// Stands in for a texture that failed to load so block texture indices stay stable:
+// a 2x2 magenta and black checker that is easy to spot in game.
+static auto get_placeholder_texture(std::string_view name, std::string_view filepath) -> TextureInfo {
+    TextureInfo texture_info;
+    texture_info.width = 2;
+    texture_info.height = 2;
+    texture_info.channels = 4;
+    texture_info.pixels = { 255, 0, 255, 255, 0, 0, 0, 255, 0, 0, 0, 255, 255, 0, 255, 255 };
+    texture_info.name = name;
+    texture_info.filepath = filepath;
 
-    return true;
+    return texture_info;
 }
 
-auto get_texture_atlas([[maybe_unused]] std::string_view info) -> TextureAtlas {
-    TextureAtlas atlas;
+static auto get_texture_entries(std::string_view info) -> std::vector<std::pair<std::string, std::string>> {
+    std::vector<std::pair<std::string, std::string>> entries;
 
     auto j = Json::parse(std::begin(info), std::end(info));
 
@@ -48,8 +59,73 @@ auto get_texture_atlas([[maybe_unused]] std::string_view info) -> TextureAtlas {
             const auto texture_filename = value_or_default(t, "name", std::string { "blank" });
             const auto texture_filepath = value_or_default(t, "file", std::string { "textures/blank.png" });
 
-            append_texture(atlas, texture_filename, "../assets/" + texture_filepath);
+            entries.emplace_back(texture_filename, "../assets/" + texture_filepath);
+        }
+    }
+
+    return entries;
+}
+
+auto append_texture(TextureAtlas& atlas, std::string_view name, std::string_view filepath) -> bool {
+    auto texture_info = load_texture(name, filepath);
+    const auto loaded = texture_info.has_value();
+
+    atlas._textures.push_back(loaded ? std::move(*texture_info) : get_placeholder_texture(name, filepath));
+
+    return loaded;
+}
+
+auto reload_texture(TextureAtlas& atlas, std::string_view filepath) -> std::optional<uint32_t> {
+    for (size_t i = 0; i < std::size(atlas._textures); i++) {
+        auto& texture = atlas._textures[i];
+        if (texture.filepath != filepath) {
+            continue;
         }
+
+        auto texture_info = load_texture(texture.name, texture.filepath);
+        if (!texture_info) {
+            return std::nullopt;
+        }
+
+        texture = std::move(*texture_info);
+        return static_cast<uint32_t>(i);
+    }
+
+    return std::nullopt;
+}
+
+auto update_texture_list(TextureAtlas& atlas, std::string_view info) -> std::vector<uint32_t> {
+    const auto entries = get_texture_entries(info);
+    std::vector<uint32_t> changed;
+
+    for (size_t i = 0; i < std::size(entries); i++) {
+        const auto& [name, filepath] = entries[i];
+        if (i < std::size(atlas._textures) && atlas._textures[i].name == name && atlas._textures[i].filepath == filepath) {
+            continue;
+        }
+
+        auto texture_info = load_texture(name, filepath).value_or(get_placeholder_texture(name, filepath));
+        if (i < std::size(atlas._textures)) {
+            atlas._textures[i] = std::move(texture_info);
+        } else {
+            atlas._textures.push_back(std::move(texture_info));
+        }
+        changed.push_back(static_cast<uint32_t>(i));
+    }
+
+    for (auto i = std::size(entries); i < std::size(atlas._textures); i++) {
+        changed.push_back(static_cast<uint32_t>(i));
+    }
+    atlas._textures.resize(std::size(entries));
+
+    return changed;
+}
+
+auto get_texture_atlas([[maybe_unused]] std::string_view info) -> TextureAtlas {
+    TextureAtlas atlas;
+
+    for (const auto& [name, filepath] : get_texture_entries(info)) {
+        append_texture(atlas, name, filepath);
     }
 
     return atlas;
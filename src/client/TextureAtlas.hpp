@@ -1,5 +1,8 @@
 #pragma once
 
+#include "TextureCompression.hpp"
+
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -9,17 +12,27 @@ struct TextureInfo {
     uint32_t width = 0;
     uint32_t height = 0;
     uint32_t channels = 0;
-    std::vector<uint8_t> pixels;
+    TextureBytes pixels;
     std::string name;
     std::string filepath;
+    std::optional<CompressedTexture> compressed; // set by compress_texture_atlas
 };
 
 struct TextureAtlas {
     std::vector<TextureInfo> _textures;
 };
 
+// Textures that fail to load, here and in update_texture_list, keep their index with a
+// placeholder so the block types referring to later ones still line up. Returns whether it loaded.
 auto append_texture(TextureAtlas& atlas, std::string_view name, std::string_view filepath) -> bool;
 
 auto get_texture_atlas(std::string_view info) -> TextureAtlas;
 
+// Rereads the texture loaded from filepath, returns its index.
+auto reload_texture(TextureAtlas& atlas, std::string_view filepath) -> std::optional<uint32_t>;
+
+// Brings the atlas in line with the texture list of resources.json, loading only the
+// entries that differ. Returns the indices that changed or were removed.
+auto update_texture_list(TextureAtlas& atlas, std::string_view info) -> std::vector<uint32_t>;
+
 } // namespace Graphics
\ No newline at end of file
@@ -0,0 +1,842 @@
+#include "TextureCompression.hpp"
+#include "Content.hpp"
+#include "Journal.hpp"
+#include "Tags.hpp"
+#include "TextureAtlas.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Graphics {
+
+using Content::ByteBuffer;
+using Content::read_value;
+using Content::write_value;
+
+static constexpr uint32_t CacheMagic = 0x58544342; // "BCTX"
+static constexpr uint32_t CacheVersion = 1;
+
+// BC7 4-bit index interpolation weights, out of 64
+static constexpr std::array<uint32_t, 16> Weights4 = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// The 16 pixels of a block stored channel by channel, so the index search can
+// compare four pixels per instruction
+struct PixelBlock {
+    alignas(16) float channels[4][16];
+};
+
+using Palette = std::array<std::array<float, 4>, 16>;
+
+struct BlockIndices {
+    std::array<uint8_t, 16> values = {};
+    float error = 0.0f;
+};
+
+static auto load_block(std::span<const uint8_t> rgba, uint32_t width, uint32_t height, uint32_t bx, uint32_t by, PixelBlock& block) -> void {
+    for (uint32_t i = 0; i < 16; i++) {
+        const auto x = std::min(bx * 4 + i % 4, width - 1);
+        const auto y = std::min(by * 4 + i / 4, height - 1);
+        const auto p = (static_cast<size_t>(y) * width + x) * 4;
+        for (uint32_t c = 0; c < 4; c++) {
+            block.channels[c][i] = static_cast<float>(rgba[p + c]);
+        }
+    }
+}
+
+// Nearest palette entry for every pixel over channels [first, first + count)
+static auto select_indices(const PixelBlock& block, const Palette& palette, uint32_t entries, uint32_t first, uint32_t count) -> BlockIndices {
+    BlockIndices result;
+
+#if defined(__SSE2__)
+    for (uint32_t group = 0; group < 16; group += 4) {
+        __m128 pixels[4];
+        for (uint32_t c = 0; c < count; c++) {
+            pixels[c] = _mm_load_ps(&block.channels[first + c][group]);
+        }
+
+        auto best = _mm_set1_ps(std::numeric_limits<float>::max());
+        auto best_index = _mm_setzero_ps();
+        for (uint32_t e = 0; e < entries; e++) {
+            auto distance = _mm_setzero_ps();
+            for (uint32_t c = 0; c < count; c++) {
+                const auto d = _mm_sub_ps(pixels[c], _mm_set1_ps(palette[e][first + c]));
+                distance = _mm_add_ps(distance, _mm_mul_ps(d, d));
+            }
+
+            const auto closer = _mm_cmplt_ps(distance, best);
+            best = _mm_min_ps(distance, best);
+            best_index = _mm_or_ps(_mm_and_ps(closer, _mm_set1_ps(static_cast<float>(e))), _mm_andnot_ps(closer, best_index));
+        }
+
+        alignas(16) float errors[4];
+        alignas(16) float indices[4];
+        _mm_store_ps(errors, best);
+        _mm_store_ps(indices, best_index);
+        for (uint32_t i = 0; i < 4; i++) {
+            result.values[group + i] = static_cast<uint8_t>(indices[i]);
+            result.error += errors[i];
+        }
+    }
+#else
+    for (uint32_t i = 0; i < 16; i++) {
+        auto best = std::numeric_limits<float>::max();
+        for (uint32_t e = 0; e < entries; e++) {
+            auto distance = 0.0f;
+            for (uint32_t c = 0; c < count; c++) {
+                const auto d = block.channels[first + c][i] - palette[e][first + c];
+                distance += d * d;
+            }
+
+            if (distance < best) {
+                best = distance;
+                result.values[i] = static_cast<uint8_t>(e);
+            }
+        }
+        result.error += best;
+    }
+#endif
+
+    return result;
+}
+
+// Principal axis of the block's colours, its extremes give the initial endpoints
+static auto find_endpoints(const PixelBlock& block, uint32_t count, std::array<float, 4>& lo, std::array<float, 4>& hi) -> void {
+    std::array<float, 4> mean = {};
+    for (uint32_t c = 0; c < count; c++) {
+        for (uint32_t i = 0; i < 16; i++) {
+            mean[c] += block.channels[c][i];
+        }
+        mean[c] /= 16.0f;
+    }
+
+    float covariance[4][4] = {};
+    for (uint32_t i = 0; i < 16; i++) {
+        for (uint32_t a = 0; a < count; a++) {
+            for (uint32_t b = 0; b < count; b++) {
+                covariance[a][b] += (block.channels[a][i] - mean[a]) * (block.channels[b][i] - mean[b]);
+            }
+        }
+    }
+
+    std::array<float, 4> axis = { 1.0f, 1.0f, 1.0f, 1.0f };
+    for (uint32_t iteration = 0; iteration < 8; iteration++) {
+        std::array<float, 4> next = {};
+        auto length = 0.0f;
+        for (uint32_t a = 0; a < count; a++) {
+            for (uint32_t b = 0; b < count; b++) {
+                next[a] += covariance[a][b] * axis[b];
+            }
+            length += next[a] * next[a];
+        }
+
+        if (length < 1e-12f) {
+            break;
+        }
+
+        for (uint32_t a = 0; a < count; a++) {
+            axis[a] = next[a] / std::sqrt(length);
+        }
+    }
+
+    auto t_min = std::numeric_limits<float>::max();
+    auto t_max = std::numeric_limits<float>::lowest();
+    for (uint32_t i = 0; i < 16; i++) {
+        auto t = 0.0f;
+        for (uint32_t c = 0; c < count; c++) {
+            t += (block.channels[c][i] - mean[c]) * axis[c];
+        }
+        t_min = std::min(t_min, t);
+        t_max = std::max(t_max, t);
+    }
+
+    for (uint32_t c = 0; c < count; c++) {
+        lo[c] = std::clamp(mean[c] + axis[c] * t_min, 0.0f, 255.0f);
+        hi[c] = std::clamp(mean[c] + axis[c] * t_max, 0.0f, 255.0f);
+    }
+}
+
+// Least squares endpoints for fixed indices, weights[i] is how far index i lies towards b
+static auto refine_endpoints(const PixelBlock& block, const BlockIndices& indices, const float* weights, uint32_t count, std::array<float, 4>& a,
+    std::array<float, 4>& b) -> bool {
+    auto aa = 0.0f, bb = 0.0f, ab = 0.0f;
+    std::array<float, 4> ax = {}, bx = {};
+
+    for (uint32_t i = 0; i < 16; i++) {
+        const auto w = weights[indices.values[i]];
+        aa += (1.0f - w) * (1.0f - w);
+        bb += w * w;
+        ab += (1.0f - w) * w;
+        for (uint32_t c = 0; c < count; c++) {
+            ax[c] += (1.0f - w) * block.channels[c][i];
+            bx[c] += w * block.channels[c][i];
+        }
+    }
+
+    const auto det = aa * bb - ab * ab;
+    if (std::abs(det) < 1e-6f) {
+        return false;
+    }
+
+    for (uint32_t c = 0; c < count; c++) {
+        a[c] = std::clamp((ax[c] * bb - bx[c] * ab) / det, 0.0f, 255.0f);
+        b[c] = std::clamp((bx[c] * aa - ax[c] * ab) / det, 0.0f, 255.0f);
+    }
+
+    return true;
+}
+
+static auto to_565(const std::array<float, 4>& color) -> uint16_t {
+    const auto r = static_cast<uint32_t>(std::lround(color[0] * 31.0f / 255.0f));
+    const auto g = static_cast<uint32_t>(std::lround(color[1] * 63.0f / 255.0f));
+    const auto b = static_cast<uint32_t>(std::lround(color[2] * 31.0f / 255.0f));
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+static auto from_565(uint16_t color) -> std::array<uint32_t, 3> {
+    const auto r = (color >> 11) & 0x1fu;
+    const auto g = (color >> 5) & 0x3fu;
+    const auto b = color & 0x1fu;
+    return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2) };
+}
+
+static auto get_color_palette(uint16_t c0, uint16_t c1) -> std::array<std::array<uint32_t, 3>, 4> {
+    const auto p0 = from_565(c0);
+    const auto p1 = from_565(c1);
+
+    std::array<std::array<uint32_t, 3>, 4> palette = { p0, p1 };
+    for (uint32_t c = 0; c < 3; c++) {
+        palette[2][c] = (2 * p0[c] + p1[c]) / 3;
+        palette[3][c] = (p0[c] + 2 * p1[c]) / 3;
+    }
+
+    return palette;
+}
+
+// Four colour mode only: c0 > c1, or a single colour with every index 0
+static auto write_color_block(const PixelBlock& block, const std::array<float, 4>& lo, const std::array<float, 4>& hi, uint8_t* out)
+    -> BlockIndices {
+    auto c0 = to_565(hi);
+    auto c1 = to_565(lo);
+    if (c0 < c1) {
+        std::swap(c0, c1);
+    }
+
+    BlockIndices indices;
+    if (c0 != c1) {
+        const auto colors = get_color_palette(c0, c1);
+        Palette palette = {};
+        for (uint32_t e = 0; e < 4; e++) {
+            for (uint32_t c = 0; c < 3; c++) {
+                palette[e][c] = static_cast<float>(colors[e][c]);
+            }
+        }
+        indices = select_indices(block, palette, 4, 0, 3);
+    } else {
+        const auto color = from_565(c0);
+        for (uint32_t i = 0; i < 16; i++) {
+            for (uint32_t c = 0; c < 3; c++) {
+                const auto d = block.channels[c][i] - static_cast<float>(color[c]);
+                indices.error += d * d;
+            }
+        }
+    }
+
+    uint32_t bits = 0;
+    for (uint32_t i = 0; i < 16; i++) {
+        bits |= static_cast<uint32_t>(indices.values[i]) << (2 * i);
+    }
+
+    memcpy(out, &c0, 2);
+    memcpy(out + 2, &c1, 2);
+    memcpy(out + 4, &bits, 4);
+
+    return indices;
+}
+
+static auto encode_color_block(const PixelBlock& block, uint8_t* out) -> void {
+    static constexpr float weights[] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+    std::array<float, 4> lo = {}, hi = {};
+    find_endpoints(block, 3, lo, hi);
+
+    const auto first = write_color_block(block, lo, hi, out);
+
+    // Refit the endpoints to the chosen indices and keep whichever is closer
+    uint16_t c0 = 0, c1 = 0;
+    memcpy(&c0, out, 2);
+    memcpy(&c1, out + 2, 2);
+    if (c0 == c1) {
+        return;
+    }
+
+    const auto p0 = from_565(c0);
+    const auto p1 = from_565(c1);
+    std::array<float, 4> a = { static_cast<float>(p0[0]), static_cast<float>(p0[1]), static_cast<float>(p0[2]), 0.0f };
+    std::array<float, 4> b = { static_cast<float>(p1[0]), static_cast<float>(p1[1]), static_cast<float>(p1[2]), 0.0f };
+    if (!refine_endpoints(block, first, weights, 3, a, b)) {
+        return;
+    }
+
+    uint8_t refined[8];
+    if (write_color_block(block, b, a, refined).error < first.error) {
+        memcpy(out, refined, 8);
+    }
+}
+
+// BC4 style alpha block using the eight value mode
+static auto encode_alpha_block(const PixelBlock& block, uint8_t* out) -> void {
+    const auto [lo, hi] = std::minmax_element(std::begin(block.channels[3]), std::end(block.channels[3]));
+    const auto a0 = static_cast<uint32_t>(*hi);
+    const auto a1 = static_cast<uint32_t>(*lo);
+
+    memset(out, 0, 8);
+    out[0] = static_cast<uint8_t>(a0);
+    out[1] = static_cast<uint8_t>(a1);
+    if (a0 == a1) {
+        return;
+    }
+
+    Palette palette = {};
+    palette[0][3] = static_cast<float>(a0);
+    palette[1][3] = static_cast<float>(a1);
+    for (uint32_t e = 2; e < 8; e++) {
+        palette[e][3] = static_cast<float>(((8 - e) * a0 + (e - 1) * a1) / 7);
+    }
+
+    const auto indices = select_indices(block, palette, 8, 3, 1);
+
+    uint64_t bits = 0;
+    for (uint32_t i = 0; i < 16; i++) {
+        bits |= static_cast<uint64_t>(indices.values[i]) << (3 * i);
+    }
+    for (uint32_t i = 0; i < 6; i++) {
+        out[2 + i] = static_cast<uint8_t>(bits >> (8 * i));
+    }
+}
+
+struct Bc7Endpoints {
+    std::array<uint32_t, 4> values[2]; // 7 bits per channel
+    uint32_t p[2] = { 0, 0 };
+};
+
+// 7 bit channels plus one shared low bit per endpoint, picking the better low bit
+static auto quantize_bc7(const std::array<float, 4>& color, std::array<uint32_t, 4>& values, uint32_t& p) -> void {
+    auto best = std::numeric_limits<float>::max();
+    for (uint32_t bit = 0; bit < 2; bit++) {
+        std::array<uint32_t, 4> q;
+        auto error = 0.0f;
+        for (uint32_t c = 0; c < 4; c++) {
+            q[c] = static_cast<uint32_t>(std::clamp(std::lround((color[c] - static_cast<float>(bit)) / 2.0f), 0l, 127l));
+            const auto d = static_cast<float>((q[c] << 1) | bit) - color[c];
+            error += d * d;
+        }
+
+        if (error < best) {
+            best = error;
+            values = q;
+            p = bit;
+        }
+    }
+}
+
+static auto get_bc7_palette(const Bc7Endpoints& endpoints) -> Palette {
+    Palette palette = {};
+    for (uint32_t e = 0; e < 16; e++) {
+        for (uint32_t c = 0; c < 4; c++) {
+            const auto e0 = (endpoints.values[0][c] << 1) | endpoints.p[0];
+            const auto e1 = (endpoints.values[1][c] << 1) | endpoints.p[1];
+            palette[e][c] = static_cast<float>(((64 - Weights4[e]) * e0 + Weights4[e] * e1 + 32) >> 6);
+        }
+    }
+
+    return palette;
+}
+
+static auto write_bc7_block(const PixelBlock& block, const std::array<float, 4>& lo, const std::array<float, 4>& hi, uint8_t* out) -> BlockIndices {
+    Bc7Endpoints endpoints;
+    quantize_bc7(lo, endpoints.values[0], endpoints.p[0]);
+    quantize_bc7(hi, endpoints.values[1], endpoints.p[1]);
+
+    auto indices = select_indices(block, get_bc7_palette(endpoints), 16, 0, 4);
+
+    // The first index is stored with 3 bits, so its top bit has to be clear
+    if (indices.values[0] >= 8) {
+        std::swap(endpoints.values[0], endpoints.values[1]);
+        std::swap(endpoints.p[0], endpoints.p[1]);
+        for (auto& index : indices.values) {
+            index = static_cast<uint8_t>(15 - index);
+        }
+    }
+
+    memset(out, 0, 16);
+    uint32_t position = 0;
+    const auto write_bits = [&](uint32_t value, uint32_t bits) {
+        for (uint32_t i = 0; i < bits; i++, position++) {
+            out[position / 8] |= static_cast<uint8_t>(((value >> i) & 1u) << (position % 8));
+        }
+    };
+
+    write_bits(1u << 6, 7); // mode 6
+    for (uint32_t c = 0; c < 4; c++) {
+        write_bits(endpoints.values[0][c], 7);
+        write_bits(endpoints.values[1][c], 7);
+    }
+    write_bits(endpoints.p[0], 1);
+    write_bits(endpoints.p[1], 1);
+    for (uint32_t i = 0; i < 16; i++) {
+        write_bits(indices.values[i], i == 0 ? 3 : 4);
+    }
+
+    return indices;
+}
+
+static auto encode_bc7_block(const PixelBlock& block, uint8_t* out) -> void {
+    static const auto weights = [] {
+        std::array<float, 16> w;
+        for (uint32_t i = 0; i < 16; i++) {
+            w[i] = static_cast<float>(Weights4[i]) / 64.0f;
+        }
+        return w;
+    }();
+
+    std::array<float, 4> lo = {}, hi = {};
+    find_endpoints(block, 4, lo, hi);
+
+    const auto first = write_bc7_block(block, lo, hi, out);
+
+    // Refit against the written orientation: index 0 maps to the first endpoint
+    std::array<float, 4> a = {}, b = {};
+    if (!refine_endpoints(block, first, std::data(weights), 4, a, b)) {
+        return;
+    }
+
+    uint8_t refined[16];
+    if (write_bc7_block(block, a, b, refined).error < first.error) {
+        memcpy(out, refined, 16);
+    }
+}
+
+static auto decode_color_block(const uint8_t* in, uint8_t* pixels, size_t stride) -> void {
+    uint16_t c0 = 0, c1 = 0;
+    uint32_t bits = 0;
+    memcpy(&c0, in, 2);
+    memcpy(&c1, in + 2, 2);
+    memcpy(&bits, in + 4, 4);
+
+    const auto palette = get_color_palette(c0, c1);
+    for (uint32_t i = 0; i < 16; i++) {
+        const auto& color = palette[(bits >> (2 * i)) & 3u];
+        auto pixel = pixels + (i / 4) * stride + (i % 4) * 4;
+        pixel[0] = static_cast<uint8_t>(color[0]);
+        pixel[1] = static_cast<uint8_t>(color[1]);
+        pixel[2] = static_cast<uint8_t>(color[2]);
+        pixel[3] = 255;
+    }
+}
+
+static auto decode_alpha_block(const uint8_t* in, uint8_t* pixels, size_t stride) -> void {
+    const uint32_t a0 = in[0];
+    const uint32_t a1 = in[1];
+
+    std::array<uint32_t, 8> palette = { a0, a1 };
+    for (uint32_t e = 2; e < 8; e++) {
+        if (a0 > a1) {
+            palette[e] = ((8 - e) * a0 + (e - 1) * a1) / 7;
+        } else {
+            palette[e] = e < 6 ? ((6 - e) * a0 + (e - 1) * a1) / 5 : (e == 6 ? 0 : 255);
+        }
+    }
+
+    uint64_t bits = 0;
+    for (uint32_t i = 0; i < 6; i++) {
+        bits |= static_cast<uint64_t>(in[2 + i]) << (8 * i);
+    }
+
+    for (uint32_t i = 0; i < 16; i++) {
+        pixels[(i / 4) * stride + (i % 4) * 4 + 3] = static_cast<uint8_t>(palette[(bits >> (3 * i)) & 7u]);
+    }
+}
+
+static auto decode_bc7_block(const uint8_t* in, uint8_t* pixels, size_t stride) -> void {
+    uint32_t position = 0;
+    const auto read_bits = [&](uint32_t bits) {
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < bits; i++, position++) {
+            value |= ((in[position / 8] >> (position % 8)) & 1u) << i;
+        }
+        return value;
+    };
+
+    // Only mode 6 is produced; anything else decodes as transparent black
+    if (read_bits(7) != (1u << 6)) {
+        for (uint32_t i = 0; i < 16; i++) {
+            memset(pixels + (i / 4) * stride + (i % 4) * 4, 0, 4);
+        }
+        return;
+    }
+
+    Bc7Endpoints endpoints;
+    for (uint32_t c = 0; c < 4; c++) {
+        endpoints.values[0][c] = read_bits(7);
+        endpoints.values[1][c] = read_bits(7);
+    }
+    endpoints.p[0] = read_bits(1);
+    endpoints.p[1] = read_bits(1);
+
+    const auto palette = get_bc7_palette(endpoints);
+    for (uint32_t i = 0; i < 16; i++) {
+        const auto& color = palette[read_bits(i == 0 ? 3 : 4)];
+        auto pixel = pixels + (i / 4) * stride + (i % 4) * 4;
+        for (uint32_t c = 0; c < 4; c++) {
+            pixel[c] = static_cast<uint8_t>(color[c]);
+        }
+    }
+}
+
+auto get_block_size(TextureFormat format) -> size_t {
+    return format == TextureFormat::BC1 ? 8 : 16;
+}
+
+auto compress_image(std::span<const uint8_t> rgba, uint32_t width, uint32_t height, TextureFormat format) -> CompressedLevel {
+    CompressedLevel level;
+    level.width = width;
+    level.height = height;
+
+    const auto blocks_x = (width + 3) / 4;
+    const auto blocks_y = (height + 3) / 4;
+    const auto block_size = get_block_size(format);
+    level.blocks.resize(static_cast<size_t>(blocks_x) * blocks_y * block_size);
+
+    PixelBlock block;
+    auto out = std::data(level.blocks);
+    for (uint32_t by = 0; by < blocks_y; by++) {
+        for (uint32_t bx = 0; bx < blocks_x; bx++, out += block_size) {
+            load_block(rgba, width, height, bx, by, block);
+
+            switch (format) {
+            case TextureFormat::BC1:
+                encode_color_block(block, out);
+                break;
+            case TextureFormat::BC3:
+                encode_alpha_block(block, out);
+                encode_color_block(block, out + 8);
+                break;
+            case TextureFormat::BC7:
+                encode_bc7_block(block, out);
+                break;
+            }
+        }
+    }
+
+    return level;
+}
+
+auto decompress_image(const CompressedLevel& level, TextureFormat format) -> std::vector<uint8_t> {
+    const auto blocks_x = (level.width + 3) / 4;
+    const auto blocks_y = (level.height + 3) / 4;
+    const auto block_size = get_block_size(format);
+    const auto stride = static_cast<size_t>(blocks_x) * 16;
+
+    // Decode whole blocks, then crop to the level size
+    std::vector<uint8_t> padded(stride * blocks_y * 4);
+    auto in = std::data(level.blocks);
+    for (uint32_t by = 0; by < blocks_y; by++) {
+        for (uint32_t bx = 0; bx < blocks_x; bx++, in += block_size) {
+            auto pixels = std::data(padded) + by * 4 * stride + bx * 16;
+            switch (format) {
+            case TextureFormat::BC1:
+                decode_color_block(in, pixels, stride);
+                break;
+            case TextureFormat::BC3:
+                decode_color_block(in + 8, pixels, stride);
+                decode_alpha_block(in, pixels, stride);
+                break;
+            case TextureFormat::BC7:
+                decode_bc7_block(in, pixels, stride);
+                break;
+            }
+        }
+    }
+
+    std::vector<uint8_t> rgba(static_cast<size_t>(level.width) * level.height * 4);
+    for (uint32_t y = 0; y < level.height; y++) {
+        memcpy(std::data(rgba) + static_cast<size_t>(y) * level.width * 4, std::data(padded) + y * stride, static_cast<size_t>(level.width) * 4);
+    }
+
+    return rgba;
+}
+
+static auto to_rgba(const TextureInfo& texture) -> std::vector<uint8_t> {
+    const auto count = static_cast<size_t>(texture.width) * texture.height;
+    std::vector<uint8_t> rgba(count * 4);
+
+    for (size_t i = 0; i < count; i++) {
+        const auto pixel = std::data(texture.pixels) + i * texture.channels;
+        auto out = std::data(rgba) + i * 4;
+        switch (texture.channels) {
+        case 1:
+        case 2:
+            out[0] = out[1] = out[2] = pixel[0];
+            out[3] = texture.channels == 2 ? pixel[1] : 255;
+            break;
+        default:
+            out[0] = pixel[0];
+            out[1] = pixel[1];
+            out[2] = pixel[2];
+            out[3] = texture.channels == 4 ? pixel[3] : 255;
+            break;
+        }
+    }
+
+    return rgba;
+}
+
+// 2x2 box filter, odd edges repeat their last row or column
+static auto downsample(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height) -> std::vector<uint8_t> {
+    const auto w = std::max(width / 2, 1u);
+    const auto h = std::max(height / 2, 1u);
+    std::vector<uint8_t> result(static_cast<size_t>(w) * h * 4);
+
+    for (uint32_t y = 0; y < h; y++) {
+        for (uint32_t x = 0; x < w; x++) {
+            const uint32_t xs[] = { std::min(x * 2, width - 1), std::min(x * 2 + 1, width - 1) };
+            const uint32_t ys[] = { std::min(y * 2, height - 1), std::min(y * 2 + 1, height - 1) };
+            for (uint32_t c = 0; c < 4; c++) {
+                uint32_t sum = 2;
+                for (const auto sy : ys) {
+                    for (const auto sx : xs) {
+                        sum += rgba[(static_cast<size_t>(sy) * width + sx) * 4 + c];
+                    }
+                }
+                result[(static_cast<size_t>(y) * w + x) * 4 + c] = static_cast<uint8_t>(sum / 4);
+            }
+        }
+    }
+
+    return result;
+}
+
+static auto hash_texture(const TextureInfo& texture, TextureFormat format, bool mipmaps) -> uint64_t {
+    auto hash = 0xcbf29ce484222325ull;
+    const auto mix = [&hash](uint64_t value) {
+        hash ^= value;
+        hash *= 0x100000001b3ull;
+    };
+
+    mix(texture.width);
+    mix(texture.height);
+    mix(texture.channels);
+    mix(static_cast<uint64_t>(format));
+    mix(mipmaps ? 1 : 0);
+    for (const auto byte : texture.pixels) {
+        mix(byte);
+    }
+
+    return hash;
+}
+
+static auto get_cache_path(const TextureInfo& texture, TextureFormat format) -> std::string {
+    switch (format) {
+    case TextureFormat::BC1:
+        return texture.filepath + ".bc1";
+    case TextureFormat::BC3:
+        return texture.filepath + ".bc3";
+    case TextureFormat::BC7:
+        return texture.filepath + ".bc7";
+    }
+
+    return texture.filepath + ".bc";
+}
+
+static auto save_cache(const std::string& path, uint64_t hash, const CompressedTexture& texture) -> bool {
+    ByteBuffer buf;
+    write_value(buf, CacheMagic);
+    write_value(buf, CacheVersion);
+    write_value(buf, hash);
+    write_value(buf, static_cast<uint8_t>(texture.format));
+    write_value(buf, texture.psnr);
+    write_value(buf, static_cast<uint32_t>(std::size(texture.levels)));
+
+    for (const auto& level : texture.levels) {
+        write_value(buf, level.width);
+        write_value(buf, level.height);
+        write_value(buf, static_cast<uint32_t>(std::size(level.blocks)));
+        buf.insert(std::end(buf), std::begin(level.blocks), std::end(level.blocks));
+    }
+
+    return Content::write(path, std::string_view { reinterpret_cast<const char*>(std::data(buf)), std::size(buf) });
+}
+
+static auto load_cache(const std::string& path, uint64_t hash, TextureFormat format, CompressedTexture& texture) -> bool {
+    const auto content = Content::read<ByteBuffer>(path);
+    if (!content) {
+        return false;
+    }
+
+    std::span<const uint8_t> data = *content;
+
+    uint32_t magic = 0, version = 0, count = 0;
+    uint64_t stored_hash = 0;
+    uint8_t stored_format = 0;
+    if (!read_value(data, magic) || magic != CacheMagic || !read_value(data, version) || version != CacheVersion || !read_value(data, stored_hash)
+        || stored_hash != hash || !read_value(data, stored_format) || stored_format != static_cast<uint8_t>(format) || !read_value(data, texture.psnr)
+        || !read_value(data, count)) {
+        return false;
+    }
+
+    texture.format = format;
+    texture.levels.resize(count);
+    for (auto& level : texture.levels) {
+        uint32_t size = 0;
+        if (!read_value(data, level.width) || !read_value(data, level.height) || !read_value(data, size) || std::size(data) < size) {
+            return false;
+        }
+
+        level.blocks.assign(std::begin(data), std::begin(data) + size);
+        data = data.subspan(size);
+    }
+
+    return true;
+}
+
+auto compress_texture_atlas(TextureAtlas& atlas, const CompressionSettings& settings) -> size_t {
+    struct Source {
+        size_t texture = 0;
+        uint64_t hash = 0;
+        std::vector<std::vector<uint8_t>> levels;
+        CompressedTexture compressed;
+    };
+
+    struct Job {
+        size_t source = 0;
+        size_t level = 0;
+    };
+
+    std::vector<Source> sources;
+    std::vector<Job> jobs;
+    size_t cached = 0;
+
+    for (size_t t = 0; t < std::size(atlas._textures); t++) {
+        auto& texture = atlas._textures[t];
+        if (texture.pixels.empty() || texture.width == 0 || texture.height == 0) {
+            continue;
+        }
+
+        auto rgba = to_rgba(texture);
+        auto opaque = true;
+        for (size_t i = 3; i < std::size(rgba); i += 4) {
+            opaque &= rgba[i] == 255;
+        }
+
+        const auto format = opaque ? settings.opaque_format : settings.alpha_format;
+        const auto hash = hash_texture(texture, format, settings.mipmaps);
+
+        if (settings.use_cache) {
+            CompressedTexture compressed;
+            if (load_cache(get_cache_path(texture, format), hash, format, compressed)) {
+                Journal::debug(Tags::Graphics, "Texture '{}' loaded from cache, PSNR {:.2f} dB", texture.name, compressed.psnr);
+                texture.compressed = std::move(compressed);
+                cached++;
+                continue;
+            }
+        }
+
+        Source source;
+        source.texture = t;
+        source.hash = hash;
+        source.compressed.format = format;
+        source.levels.push_back(std::move(rgba));
+
+        for (auto w = texture.width, h = texture.height; settings.mipmaps && (w > 1 || h > 1); w = std::max(w / 2, 1u), h = std::max(h / 2, 1u)) {
+            source.levels.push_back(downsample(source.levels.back(), w, h));
+        }
+
+        source.compressed.levels.resize(std::size(source.levels));
+        for (size_t l = 0; l < std::size(source.levels); l++) {
+            jobs.push_back({ std::size(sources), l });
+        }
+
+        sources.push_back(std::move(source));
+    }
+
+    // Every texture level is an independent job
+    {
+        const auto hardware = std::max(std::thread::hardware_concurrency(), 1u);
+        const auto count = std::min<size_t>(settings.threads != 0 ? settings.threads : hardware, std::size(jobs));
+
+        std::atomic_size_t next = 0;
+        std::vector<std::jthread> workers;
+        for (size_t i = 0; i < count; i++) {
+            workers.emplace_back([&] {
+                for (auto j = next++; j < std::size(jobs); j = next++) {
+                    auto& source = sources[jobs[j].source];
+                    const auto& texture = atlas._textures[source.texture];
+                    const auto level = jobs[j].level;
+                    const auto width = std::max(texture.width >> level, 1u);
+                    const auto height = std::max(texture.height >> level, 1u);
+
+                    source.compressed.levels[level] = compress_image(source.levels[level], width, height, source.compressed.format);
+                }
+            });
+        }
+    }
+
+    for (auto& source : sources) {
+        auto& texture = atlas._textures[source.texture];
+        auto& compressed = source.compressed;
+
+        // Alpha only counts when the format stores it
+        const auto channels = compressed.format == TextureFormat::BC1 ? 3u : 4u;
+        auto squared = 0.0;
+        size_t samples = 0;
+        size_t bytes = 0;
+        for (size_t l = 0; l < std::size(source.levels); l++) {
+            const auto decoded = decompress_image(compressed.levels[l], compressed.format);
+            for (size_t i = 0; i < std::size(decoded); i++) {
+                if (i % 4 < channels) {
+                    const auto d = static_cast<double>(decoded[i]) - static_cast<double>(source.levels[l][i]);
+                    squared += d * d;
+                    samples++;
+                }
+            }
+            bytes += std::size(compressed.levels[l].blocks);
+        }
+
+        const auto mse = squared / static_cast<double>(std::max<size_t>(samples, 1));
+        compressed.psnr = mse > 0.0 ? static_cast<float>(10.0 * std::log10(255.0 * 255.0 / mse)) : std::numeric_limits<float>::infinity();
+
+        Journal::message(Tags::Graphics, "Texture '{}' {}x{} BC{} {} levels {} bytes, PSNR {:.2f} dB", texture.name, texture.width, texture.height,
+            compressed.format == TextureFormat::BC1 ? 1 : (compressed.format == TextureFormat::BC3 ? 3 : 7), std::size(compressed.levels), bytes,
+            compressed.psnr);
+
+        if (settings.use_cache && !save_cache(get_cache_path(texture, compressed.format), source.hash, compressed)) {
+            Journal::warning(Tags::Graphics, "Failed to write texture cache for '{}'", texture.name);
+        }
+
+        texture.compressed = std::move(compressed);
+    }
+
+    if (!settings.keep_pixels) {
+        for (auto& texture : atlas._textures) {
+            if (texture.compressed) {
+                texture.pixels.clear();
+                texture.pixels.shrink_to_fit();
+            }
+        }
+    }
+
+    return cached;
+}
+
+} // namespace Graphics
\ No newline at end of file
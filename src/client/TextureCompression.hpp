@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Memory.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Graphics {
+
+struct TextureAtlas;
+
+// Block-compressed formats, 4x4 pixels per block
+enum class TextureFormat : uint8_t {
+    BC1, // RGB, 8 bytes per block
+    BC3, // RGBA, BC1 colour plus an interpolated alpha block, 16 bytes per block
+    BC7, // RGBA, single subset mode 6 only, 16 bytes per block
+};
+
+using TextureBytes = std::vector<uint8_t, Memory::TrackedAllocator<uint8_t, Memory::Subsystem::Textures>>;
+
+struct CompressedLevel {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    TextureBytes blocks;
+};
+
+struct CompressedTexture {
+    TextureFormat format = TextureFormat::BC1;
+    std::vector<CompressedLevel> levels; // full size first, then each mip
+    float psnr = 0.0f; // over all levels and channels, in dB
+};
+
+struct CompressionSettings {
+    TextureFormat opaque_format = TextureFormat::BC1;
+    TextureFormat alpha_format = TextureFormat::BC3;
+    bool mipmaps = true;
+    bool use_cache = true; // read and write "<texture file>.bcN" next to the asset
+    bool keep_pixels = false; // drop the uncompressed pixels once encoded
+    uint32_t threads = 0; // 0 picks the hardware concurrency
+};
+
+auto get_block_size(TextureFormat format) -> size_t;
+
+// Encodes tightly packed RGBA8 pixels; edge blocks repeat the last row and column.
+auto compress_image(std::span<const uint8_t> rgba, uint32_t width, uint32_t height, TextureFormat format) -> CompressedLevel;
+auto decompress_image(const CompressedLevel& level, TextureFormat format) -> std::vector<uint8_t>;
+
+// Compresses every texture of the atlas, all textures and mip levels in parallel,
+// and logs the PSNR of each. Returns how many textures came from the cache.
+auto compress_texture_atlas(TextureAtlas& atlas, const CompressionSettings& settings) -> size_t;
+
+} // namespace Graphics
\ No newline at end of file
@@ -38,9 +38,17 @@ static auto is_mouse_pressed(std::shared_ptr<Window> window, int button) noexcep
     input.backward = is_key_pressed(w, GLFW_KEY_S);
     input.left = is_key_pressed(w, GLFW_KEY_D);
     input.right = is_key_pressed(w, GLFW_KEY_A);
+    input.jump = is_key_pressed(w, GLFW_KEY_SPACE);
     input.button_left = is_mouse_pressed(w, GLFW_MOUSE_BUTTON_LEFT);
     input.button_right = is_mouse_pressed(w, GLFW_MOUSE_BUTTON_RIGHT);
 
+    double x = 0.0, y = 0.0;
+    glfwGetCursorPos(w->window, &x, &y);
+    input.look_x = static_cast<float>(x - w->cursor_x);
+    input.look_y = static_cast<float>(y - w->cursor_y);
+    w->cursor_x = x;
+    w->cursor_y = y;
+
     glfwPollEvents();
     return true;
 }
@@ -62,6 +70,8 @@ static auto is_mouse_pressed(std::shared_ptr<Window> window, int button) noexcep
         center_window(window, glfwGetPrimaryMonitor());
     }
 
+    // Hidden and unbounded, the cursor only steers the camera
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     glfwSetCursorPos(window, info.width / 2.f, info.height / 2.f);
     glfwShowWindow(window);
 
@@ -70,6 +80,7 @@ static auto is_mouse_pressed(std::shared_ptr<Window> window, int button) noexcep
     w.width = info.width;
     w.height = info.height;
     w.window = window;
+    glfwGetCursorPos(window, &w.cursor_x, &w.cursor_y);
 
     return std::make_shared<Window>(w);
 }
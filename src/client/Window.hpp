@@ -12,6 +12,8 @@ struct Window {
     int32_t width = 0;
     int32_t height = 0;
     GLFWwindow* window = nullptr;
+    double cursor_x = 0.0; // where the cursor was at the last process_window_events
+    double cursor_y = 0.0;
 };
 
 struct CreateWindowInfo {
@@ -26,6 +28,9 @@ struct Input {
     bool backward = false;
     bool right = false;
     bool left = false;
+    bool jump = false;
+    float look_x = 0.0f; // cursor movement since the last frame, in pixels
+    float look_y = 0.0f;
 
     bool button_left = false;
     bool button_right = false;
@@ -1,4 +1,8 @@
 #include "World.hpp"
+#include "Lod.hpp"
+
+#include <algorithm>
+#include <new>
 
 namespace Game {
 
@@ -11,7 +15,334 @@ auto create_world() -> World {
 auto destroy_world([[maybe_unused]] World& world) -> void {
 }
 
-auto update_world([[maybe_unused]] World& world) -> void {
+auto update_world(World& world, const BlockTypes& block_types, const SimulationSettings& settings) -> SimulationStats {
+    return step_simulation(world, world._simulation, block_types, settings);
+}
+
+using ChunkAllocator = Memory::TrackedAllocator<Chunk, Memory::Subsystem::Chunks>;
+
+auto ChunkDeleter::operator()(Chunk* chunk) const noexcept -> void {
+    chunk->~Chunk();
+    ChunkAllocator {}.deallocate(chunk, 1);
+}
+
+auto add_chunk(World& world, Chunk&& chunk) -> Chunk& {
+    const auto key = chunk_key(chunk._position);
+
+    if (const auto it = world._chunk_index.find(key); it != std::end(world._chunk_index)) {
+        *world._chunks[it->second] = std::move(chunk);
+        return *world._chunks[it->second];
+    }
+
+    const auto position = chunk._position;
+
+    world._chunk_index.emplace(key, std::size(world._chunks));
+    ChunkPointer stored { new (ChunkAllocator {}.allocate(1)) Chunk(std::move(chunk)) };
+    world._chunks.push_back(std::move(stored));
+
+    auto& column = world._columns[column_key({ position.x, position.z })];
+    column.top = std::max(column.top, position.y);
+    column.chunks++;
+
+    // Faces on the shared border of the vertical neighbours may now be hidden
+    if (auto below = find_chunk(world, position - ivec3 { 0, 1, 0 }); below) {
+        below->_dirty_sections |= static_cast<uint8_t>(1u << (Chunk::SectionCount - 1));
+    }
+    if (auto above = find_chunk(world, position + ivec3 { 0, 1, 0 }); above) {
+        above->_dirty_sections |= 1u;
+    }
+
+    // and the side faces of the horizontal ones are now shaded by its light instead of the sky
+    for (const auto& offset : { ivec3 { -1, 0, 0 }, ivec3 { 1, 0, 0 }, ivec3 { 0, 0, -1 }, ivec3 { 0, 0, 1 } }) {
+        if (auto neighbour = find_chunk(world, position + offset); neighbour) {
+            neighbour->_dirty_sections = static_cast<uint8_t>((1u << Chunk::SectionCount) - 1);
+        }
+    }
+
+    return *world._chunks.back();
+}
+
+auto remove_chunk(World& world, const ivec3& position) -> bool {
+    const auto it = world._chunk_index.find(chunk_key(position));
+    if (it == std::end(world._chunk_index)) {
+        return false;
+    }
+
+    // Move the last chunk into the hole to keep the storage dense
+    const auto index = it->second;
+    world._chunk_index.erase(it);
+
+    if (index + 1 != std::size(world._chunks)) {
+        world._chunks[index] = std::move(world._chunks.back());
+        world._chunk_index[chunk_key(world._chunks[index]->_position)] = index;
+    }
+
+    world._chunks.pop_back();
+
+    // Lower the column top past any gap the removal left, compacted chunks still count
+    const auto column = world._columns.find(column_key({ position.x, position.z }));
+    if (--column->second.chunks == 0 && column->second.far == 0) {
+        column->second.top = std::numeric_limits<int32_t>::min();
+    } else if (column->second.top == position.y && !world._far_chunks.contains(chunk_key(position))) {
+        auto top = position.y - 1;
+        while (!find_chunk(world, { position.x, top, position.z }) && !world._far_chunks.contains(chunk_key({ position.x, top, position.z }))) {
+            top--;
+        }
+        column->second.top = top;
+    }
+
+    return true;
+}
+
+auto find_chunk(World& world, const ivec3& position) -> Chunk* {
+    const auto it = world._chunk_index.find(chunk_key(position));
+    if (it == std::end(world._chunk_index)) {
+        return nullptr;
+    }
+
+    return world._chunks[it->second].get();
+}
+
+auto find_chunk(const World& world, const ivec3& position) -> const Chunk* {
+    const auto it = world._chunk_index.find(chunk_key(position));
+    if (it == std::end(world._chunk_index)) {
+        return nullptr;
+    }
+
+    return world._chunks[it->second].get();
+}
+
+auto find_column(const World& world, const ivec2& column) -> const ChunkColumn* {
+    const auto it = world._columns.find(column_key(column));
+    if (it == std::end(world._columns)) {
+        return nullptr;
+    }
+
+    return &it->second;
+}
+
+auto allocate_chunk(World& world, const ivec3& position) -> std::vector<ivec3> {
+    std::vector<ivec3> added;
+
+    const auto column = find_column(world, { position.x, position.z });
+    if (!column || find_chunk(world, position)) {
+        return added;
+    }
+
+    if (world._far_chunks.contains(chunk_key(position))) {
+        expand_chunk(world, position);
+        added.push_back(position);
+        return added;
+    }
+
+    // Sky and gaps above the bottom are air, add_chunk raises the top
+    const auto fill = column->fill;
+    const auto bottom = column->bottom;
+    if (position.y >= bottom) {
+        auto& chunk = add_chunk(world, create_chunk(position));
+        chunk._dirty_sections = static_cast<uint8_t>((1u << Chunk::SectionCount) - 1);
+        added.push_back(position);
+        return added;
+    }
+
+    // Below it, everything from the old bottom down to position stops being implicit
+    for (auto y = bottom - 1; y >= position.y; y--) {
+        const auto chunk_position = ivec3 { position.x, y, position.z };
+        auto& chunk = add_chunk(world, create_chunk(chunk_position));
+        fill_chunk(chunk, 0, Chunk::Size, fill);
+        chunk._dirty_sections = static_cast<uint8_t>((1u << Chunk::SectionCount) - 1);
+        added.push_back(chunk_position);
+    }
+
+    world._columns[column_key({ position.x, position.z })].bottom = position.y;
+
+    return added;
+}
+
+auto get_implicit_block(const World& world, const ivec3& position) -> uint32_t {
+    const auto column = find_column(world, { position.x, position.z });
+    return column && position.y < column->bottom ? column->fill : 0;
+}
+
+auto is_open_sky(const World& world, const ivec3& position) -> bool {
+    const auto column = find_column(world, { position.x, position.z });
+    return !column || (position.y > column->top && position.y >= column->bottom);
+}
+
+auto update_chunk_meshes(World& world, const BlockTypes& block_types, size_t limit) -> size_t {
+    size_t rebuilt = 0;
+
+    for (auto& pointer : world._chunks) {
+        auto& chunk = *pointer;
+        if (rebuilt == limit) {
+            break;
+        }
+
+        if (chunk._dirty_sections == 0) {
+            continue;
+        }
+
+        const auto& position = chunk._position;
+        const auto below = position - ivec3 { 0, 1, 0 };
+        build_chunk_lod(chunk, block_types, chunk._lod,
+            { .above = find_chunk(world, position + ivec3 { 0, 1, 0 }),
+                .below = find_chunk(world, below),
+                .left = find_chunk(world, position - ivec3 { 1, 0, 0 }),
+                .right = find_chunk(world, position + ivec3 { 1, 0, 0 }),
+                .front = find_chunk(world, position - ivec3 { 0, 0, 1 }),
+                .back = find_chunk(world, position + ivec3 { 0, 0, 1 }),
+                .buried = get_implicit_block(world, below) != 0 });
+
+        // Coarser meshes reuse the buffers of finer ones, give the slack back
+        if (chunk._vertices.capacity() > 2 * std::size(chunk._vertices)) {
+            chunk._vertices.shrink_to_fit();
+            chunk._indices.shrink_to_fit();
+        }
+
+        rebuilt++;
+    }
+
+    return rebuilt;
+}
+
+auto get_visible_chunks(const World& world, const Frustum& frustum, std::vector<const Chunk*>& visible) -> size_t {
+    visible.clear();
+
+    for (const auto& chunk : world._chunks) {
+        if (chunk->_index_count == 0) {
+            continue;
+        }
+
+        const auto [y_begin, y_end] = get_chunk_extent(*chunk);
+        const auto origin = vec3 { chunk_origin(chunk->_position) };
+        const auto lo = origin + vec3 { 0.0f, static_cast<float>(y_begin), 0.0f };
+        const auto hi = origin + vec3 { static_cast<float>(Chunk::Size), static_cast<float>(y_end), static_cast<float>(Chunk::Size) };
+
+        if (is_box_visible(frustum, lo, hi)) {
+            visible.push_back(chunk.get());
+        }
+    }
+
+    return std::size(visible);
+}
+
+auto mark_blocks_dirty(World& world, std::span<const uint32_t> blocks) -> std::vector<ivec3> {
+    std::vector<ivec3> marked;
+    if (blocks.empty()) {
+        return marked;
+    }
+
+    std::vector<uint8_t> affected(*std::max_element(std::begin(blocks), std::end(blocks)) + 1, 0);
+    for (const auto block : blocks) {
+        affected[block] = 1;
+    }
+
+    const auto is_affected = [&affected](uint32_t block) { return block < std::size(affected) && affected[block] != 0; };
+
+    for (auto& pointer : world._chunks) {
+        auto& chunk = *pointer;
+        uint8_t dirty = 0;
+
+        for (size_t s = 0; s < Chunk::SectionCount; s++) {
+            const auto& section = chunk._sections[s];
+            if (section._uniform) {
+                dirty |= is_affected(section._block) ? static_cast<uint8_t>(1u << s) : 0;
+                continue;
+            }
+
+            const auto first = &chunk._blocks[s * Chunk::SectionSize][0][0];
+            if (std::any_of(first, first + Chunk::SectionVolume, is_affected)) {
+                dirty |= static_cast<uint8_t>(1u << s);
+            }
+        }
+
+        if (dirty != 0) {
+            chunk._dirty_sections |= dirty;
+            marked.push_back(chunk._position);
+        }
+    }
+
+    return marked;
+}
+
+static auto is_over_budget(Memory::Subsystem subsystem, size_t budget) -> bool {
+    return budget != 0 && Memory::get_usage(subsystem).current > static_cast<int64_t>(budget);
+}
+
+auto enforce_memory_budget(World& world, const BlockTypes& block_types, const MemoryBudget& budget, const LodSettings& lod, float& lod_scale,
+    size_t mesh_limit) -> BudgetActions {
+    constexpr auto Step = 0.75f;
+
+    const auto half = static_cast<float>(Chunk::Size) * 0.5f;
+    const auto camera = world._camera._position;
+
+    BudgetActions actions;
+
+    if (is_over_budget(Memory::Subsystem::Chunks, budget.chunks)) {
+        // Octrees keep the unsaved flags, so edited chunks are compacted like any other
+        std::vector<std::pair<float, ivec3>> candidates;
+        for (const auto& chunk : world._chunks) {
+            const auto distance = glm::length(vec3 { chunk_origin(chunk->_position) } + vec3 { half } - camera);
+            if (distance > budget.keep_radius) {
+                candidates.emplace_back(distance, chunk->_position);
+            }
+        }
+
+        std::sort(std::begin(candidates), std::end(candidates), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        for (const auto& [distance, position] : candidates) {
+            if (!is_over_budget(Memory::Subsystem::Chunks, budget.chunks)) {
+                break;
+            }
+
+            actions.compacted += compact_chunk(world, position) ? 1 : 0;
+        }
+    }
+
+    // Coarser meshes only free memory once rebuilt, so wait for the last step's remeshing
+    // before taking another; the streaming path keeps working through it meanwhile.
+    const auto remeshing = std::any_of(std::begin(world._chunks), std::end(world._chunks), [](const auto& chunk) { return chunk->_dirty_sections != 0; });
+    const auto meshes = Memory::get_usage(Memory::Subsystem::Meshes).current;
+
+    if (is_over_budget(Memory::Subsystem::Meshes, budget.meshes)) {
+        if (!remeshing && lod.distances.back() * lod_scale > budget.keep_radius) {
+            lod_scale *= Step;
+            actions.downgraded = select_chunk_lods(world, scale_lod_distances(lod, lod_scale, budget.keep_radius));
+            update_chunk_meshes(world, block_types, mesh_limit);
+        }
+    } else if (lod_scale < 1.0f && !remeshing
+        && (budget.meshes == 0 || meshes < static_cast<int64_t>(static_cast<float>(budget.meshes) * budget.recover))) {
+        lod_scale = std::min(lod_scale / Step, 1.0f);
+    }
+
+    const std::pair<Memory::Subsystem, size_t> limits[] = {
+        { Memory::Subsystem::Chunks, budget.chunks },
+        { Memory::Subsystem::Meshes, budget.meshes },
+        { Memory::Subsystem::FarChunks, budget.far_chunks },
+    };
+
+    for (const auto& [subsystem, limit] : limits) {
+        if (is_over_budget(subsystem, limit)) {
+            actions.over |= 1u << static_cast<uint32_t>(subsystem);
+        }
+    }
+
+    return actions;
+}
+
+auto get_block(const World& world, const ivec3& position) -> uint32_t {
+    const auto chunk_position = world_to_chunk(position);
+    const auto local = world_to_local(position);
+
+    if (const auto chunk = find_chunk(world, chunk_position); chunk) {
+        return chunk->_blocks[local.y][local.x][local.z];
+    }
+
+    if (const auto it = world._far_chunks.find(chunk_key(chunk_position)); it != std::end(world._far_chunks)) {
+        return get_block(it->second, local);
+    }
+
+    return get_implicit_block(world, chunk_position);
 }
 
 } // namespace Game
\ No newline at end of file
@@ -1,19 +1,150 @@
 #pragma once
 
+#include <limits>
+#include <memory>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
 #include "Camera.hpp"
 #include "Chunk.hpp"
+#include "Collision.hpp"
+#include "Frustum.hpp"
+#include "Lod.hpp"
+#include "Octree.hpp"
+#include "Raycast.hpp"
+#include "Simulation.hpp"
 
 namespace Game {
 
+// Vertical extent of a column of chunks. Chunks above the highest loaded one are
+// open sky and chunks below bottom are uniformly fill; neither is ever allocated.
+struct ChunkColumn {
+    int32_t top = std::numeric_limits<int32_t>::min();
+    int32_t bottom = std::numeric_limits<int32_t>::min();
+    uint32_t fill = 0;
+    uint32_t chunks = 0; // loaded chunks in the column
+    uint32_t far = 0; // compacted chunks, they keep the column's extent like loaded ones
+};
+
+using ChunkIndex = std::unordered_map<uint64_t, size_t>;
+using ChunkColumns = std::unordered_map<uint64_t, ChunkColumn>;
+using FarChunks = std::unordered_map<uint64_t, Octree>;
+// Each chunk is its own tracked allocation, so the budget is charged for live chunks
+// only and growing or compacting the storage never moves one.
+struct ChunkDeleter {
+    auto operator()(Chunk* chunk) const noexcept -> void;
+};
+
+using ChunkPointer = std::unique_ptr<Chunk, ChunkDeleter>;
+using Chunks = std::vector<ChunkPointer>;
+
 struct World {
-    std::vector<Chunk> _chunks;
+    Chunks _chunks;
+    ChunkIndex _chunk_index;
+    ChunkColumns _columns;
+    FarChunks _far_chunks; // compacted chunks that are not meshed at full detail
+    Simulation _simulation;
     Camera _camera;
+    Body _player; // the camera follows its eyes
+    RayHit _target; // last block picked with the mouse
+};
+
+// Byte limits per subsystem, 0 leaves a subsystem unbounded
+struct MemoryBudget {
+    size_t chunks = 0; // loaded chunks, over it the farthest are compacted into octrees
+    size_t meshes = 0; // over it the level of detail distances shrink
+    size_t far_chunks = 0; // reported only, octrees are the last resort before unloading
+    float keep_radius = 128.0f; // chunks this close to the camera are neither compacted nor coarsened
+    float recover = 0.75f; // meshes under this fraction of their budget let the distances grow back
+};
+
+struct BudgetActions {
+    size_t compacted = 0;
+    size_t downgraded = 0; // chunks remeshed at a coarser level
+    uint32_t over = 0; // bit per Memory::Subsystem still over budget afterwards
 };
 
+// 21 bits per axis
+inline auto chunk_key(const ivec3& position) -> uint64_t {
+    constexpr uint64_t mask = (1ull << 21) - 1;
+    return ((static_cast<uint64_t>(static_cast<uint32_t>(position.x)) & mask) << 42)
+        | ((static_cast<uint64_t>(static_cast<uint32_t>(position.y)) & mask) << 21) | (static_cast<uint64_t>(static_cast<uint32_t>(position.z)) & mask);
+}
+
+// 22 bits of x and z, 20 bits of y: unique within 2^22 blocks horizontally and 2^20
+// blocks (16384 chunks) vertically, positions further apart alias.
+inline auto block_key(const ivec3& position) -> uint64_t {
+    constexpr uint64_t mask = (1ull << 22) - 1;
+    constexpr uint64_t y_mask = (1ull << 20) - 1;
+    return ((static_cast<uint64_t>(static_cast<uint32_t>(position.x)) & mask) << 42)
+        | ((static_cast<uint64_t>(static_cast<uint32_t>(position.z)) & mask) << 20) | (static_cast<uint64_t>(static_cast<uint32_t>(position.y)) & y_mask);
+}
+
+inline auto column_key(const ivec2& column) -> uint64_t {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(column.x)) << 32) | static_cast<uint32_t>(column.y);
+}
+
+inline auto world_to_chunk(const ivec3& position) -> ivec3 {
+    constexpr auto size = static_cast<int32_t>(Chunk::Size);
+    const auto x = position.x >= 0 ? position.x / size : (position.x - size + 1) / size;
+    const auto y = position.y >= 0 ? position.y / size : (position.y - size + 1) / size;
+    const auto z = position.z >= 0 ? position.z / size : (position.z - size + 1) / size;
+    return ivec3 { x, y, z };
+}
+
+inline auto world_to_local(const ivec3& position) -> ivec3 {
+    constexpr auto mask = static_cast<int32_t>(Chunk::Size - 1);
+    return ivec3 { position.x & mask, position.y & mask, position.z & mask };
+}
+
+inline auto chunk_origin(const ivec3& position) -> ivec3 {
+    return position * static_cast<int32_t>(Chunk::Size);
+}
+
 auto create_world() -> World;
 auto destroy_world(World& world) -> void;
-auto update_world(World& world) -> void;
+// One simulation tick; apply_edits and the chunks streamed in wake the cells it ticks.
+auto update_world(World& world, const BlockTypes& block_types, const SimulationSettings& settings) -> SimulationStats;
+
+// Pointers returned by find_chunk stay valid until that chunk is removed.
+auto add_chunk(World& world, Chunk&& chunk) -> Chunk&;
+auto remove_chunk(World& world, const ivec3& position) -> bool;
+auto find_chunk(World& world, const ivec3& position) -> Chunk*;
+auto find_chunk(const World& world, const ivec3& position) -> const Chunk*;
+auto find_column(const World& world, const ivec2& column) -> const ChunkColumn*;
+
+// Makes the chunk at position writable in a column that is already known: a compacted
+// chunk is expanded, a missing one is seeded with its implicit block. Chunks between it
+// and the column's bottom are allocated as fill as well, so the bottom can move down.
+// Returns every chunk added, none of them lit; empty when the column is unknown.
+auto allocate_chunk(World& world, const ivec3& position) -> std::vector<ivec3>;
+
+// Block filling an unallocated chunk: the column fill below its bottom, air otherwise.
+auto get_implicit_block(const World& world, const ivec3& position) -> uint32_t;
+
+// True when an unallocated chunk lies above everything loaded in its column.
+auto is_open_sky(const World& world, const ivec3& position) -> bool;
+
+// Rebuilds the meshes of at most limit chunks with dirty sections at their current
+// level of detail, returns how many were rebuilt.
+auto update_chunk_meshes(World& world, const BlockTypes& block_types, size_t limit = std::numeric_limits<size_t>::max()) -> size_t;
+
+// Fills visible with the meshed chunks inside the frustum. Each chunk is tested with the
+// box of its non-empty sections, so the sky above the ground is never drawn.
+auto get_visible_chunks(const World& world, const Frustum& frustum, std::vector<const Chunk*>& visible) -> size_t;
+
+// Flags the sections holding any of the blocks for remeshing; uniform sections are
+// answered from their summary. Returns the chunks that were flagged.
+auto mark_blocks_dirty(World& world, std::span<const uint32_t> blocks) -> std::vector<ivec3>;
+
+// Brings chunks and meshes back under budget, one step per call: compacts the farthest
+// chunks, then lowers lod_scale by a quarter and remeshes up to mesh_limit chunks. Once
+// the remeshing settles and meshes are well under budget, lod_scale grows back to 1.
+auto enforce_memory_budget(World& world, const BlockTypes& block_types, const MemoryBudget& budget, const LodSettings& lod, float& lod_scale,
+    size_t mesh_limit) -> BudgetActions;
+
+// Falls back to compacted chunks, then to the implicit block of the column.
+auto get_block(const World& world, const ivec3& position) -> uint32_t;
 
 } // namespace Game
\ No newline at end of file
@@ -1,7 +1,44 @@
 #include "Application.hpp"
+#include "Journal.hpp"
+#include "Tags.hpp"
 
-extern int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
+#include <charconv>
+
+// --record <file> writes the session's input, --replay <file|sprint|spiral|teleports>
+// runs it headless, --frames <n> sets the length of scripted paths and --bodies <n> the
+// number of falling boxes stepped alongside.
+extern int main(int argc, char* argv[]) {
     Application::Configuration conf;
+
+    const auto parse_count = [](std::string_view option, std::string_view value, size_t& count) {
+        const auto end = std::data(value) + std::size(value);
+        if (const auto [last, ec] = std::from_chars(std::data(value), end, count); ec != std::errc {} || last != end) {
+            Journal::warning(Tags::App, "Invalid value '{}' for option '{}'", value, option);
+        }
+    };
+
+    for (int i = 1; i < argc; i += 2) {
+        const std::string_view option = argv[i];
+        if (i + 1 == argc) {
+            Journal::warning(Tags::App, "Missing value for option '{}'", option);
+            break;
+        }
+
+        const std::string_view value = argv[i + 1];
+
+        if (option == "--record") {
+            conf.record_file = value;
+        } else if (option == "--replay") {
+            conf.replay = value;
+        } else if (option == "--frames") {
+            parse_count(option, value, conf.replay_frames);
+        } else if (option == "--bodies") {
+            parse_count(option, value, conf.replay_bodies);
+        } else {
+            Journal::warning(Tags::App, "Unknown option '{}'", option);
+        }
+    }
+
     Application::Application app;
     return Application::run(conf, app);
 }
\ No newline at end of file
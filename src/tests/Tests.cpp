@@ -0,0 +1,260 @@
+#include "Chunk.hpp"
+#include "Generator.hpp"
+#include "Lighting.hpp"
+#include "Octree.hpp"
+#include "Replay.hpp"
+#include "Storage.hpp"
+#include "Streaming.hpp"
+#include "TextureAtlas.hpp"
+#include "World.hpp"
+
+#include <fmt/format.h>
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string_view>
+
+namespace {
+
+using namespace Game;
+
+constexpr ivec2 Column = ivec2 { 3, -2 };
+const auto Layers = TerrainLayers { .surface = 1, .soil = 2, .stone = 3 };
+
+auto make_block_types() -> BlockTypes {
+    BlockTypes block_types(4);
+    for (uint32_t i = 0; i < std::size(block_types); i++) {
+        auto& type = block_types[i];
+        type.frontTexture = type.leftTexture = type.rightTexture = type.backTexture = type.topTexture = type.bottomTexture = i;
+        type.topColor = vec3 { 0.5f + 0.1f * static_cast<float>(i), 1.0f, 0.5f };
+    }
+    return block_types;
+}
+
+// The surface of this column crosses a chunk border and has solid sections under it
+auto make_world(const BlockTypes& block_types) -> World {
+    auto world = create_world();
+    generate_column(world, Column, get_terrain_heights(Column), Layers);
+    for (auto& chunk : world._chunks) {
+        light_chunk(world, *chunk, block_types);
+    }
+
+    return world;
+}
+
+auto get_neighbours(World& world, const ivec3& position) -> ChunkNeighbours {
+    const auto below = position - ivec3 { 0, 1, 0 };
+    return { .above = find_chunk(world, position + ivec3 { 0, 1, 0 }),
+        .below = find_chunk(world, below),
+        .left = find_chunk(world, position - ivec3 { 1, 0, 0 }),
+        .right = find_chunk(world, position + ivec3 { 1, 0, 0 }),
+        .front = find_chunk(world, position - ivec3 { 0, 0, 1 }),
+        .back = find_chunk(world, position + ivec3 { 0, 0, 1 }),
+        .buried = get_implicit_block(world, below) != 0 };
+}
+
+auto is_same_mesh(const Chunk& a, const Chunk& b) -> bool {
+    return std::size(a._vertices) == std::size(b._vertices) && std::size(a._indices) == std::size(b._indices)
+        && memcmp(std::data(a._vertices), std::data(b._vertices), std::size(a._vertices) * sizeof(Vertex)) == 0
+        && std::equal(std::begin(a._indices), std::end(a._indices), std::begin(b._indices));
+}
+
+auto is_same_blocks(const Chunk& a, const Chunk& b) -> bool {
+    return memcmp(a._blocks, b._blocks, sizeof(a._blocks)) == 0;
+}
+
+auto get_scratch_path(std::string_view name) -> std::string {
+    return (std::filesystem::temp_directory_path() / fmt::format("vkvoxels-test-{}", name)).string();
+}
+
+// build_chunk against the same chunk with every section marked mixed, which scans all voxels
+auto test_mesh_equivalence() -> bool {
+    const auto block_types = make_block_types();
+    auto world = make_world(block_types);
+
+    size_t solid_sections = 0;
+    for (auto& pointer : world._chunks) {
+        auto& chunk = *pointer;
+        const auto neighbours = get_neighbours(world, chunk._position);
+        build_chunk(chunk, block_types, neighbours);
+
+        auto baseline = std::make_unique<Chunk>(chunk);
+        for (auto& section : baseline->_sections) {
+            solid_sections += is_section_solid(section);
+            section._solid_count = 1;
+            section._uniform = false;
+            section._opaque_faces = 0;
+        }
+        build_chunk(*baseline, block_types, neighbours);
+
+        if (!is_same_mesh(chunk, *baseline)) {
+            fmt::print(stderr, "chunk ({}, {}, {}): {} vertices, {} in the full scan\n", chunk._position.x, chunk._position.y, chunk._position.z,
+                std::size(chunk._vertices), std::size(baseline->_vertices));
+            return false;
+        }
+    }
+
+    return solid_sections > 0;
+}
+
+auto test_chunk_storage() -> bool {
+    const auto block_types = make_block_types();
+    auto world = make_world(block_types);
+
+    for (const auto& chunk : world._chunks) {
+        const auto data = save_chunk(*chunk);
+        auto loaded = std::make_unique<Chunk>();
+        if (!load_chunk(data, *loaded) || loaded->_position != chunk->_position || !is_same_blocks(*chunk, *loaded)) {
+            return false;
+        }
+
+        for (size_t s = 0; s < Chunk::SectionCount; s++) {
+            const auto& a = chunk->_sections[s];
+            const auto& b = loaded->_sections[s];
+            if (a._block != b._block || a._solid_count != b._solid_count || a._uniform != b._uniform || a._opaque_faces != b._opaque_faces) {
+                return false;
+            }
+        }
+
+        // Truncated data must be refused, not read past
+        if (load_chunk(std::span { data }.first(std::size(data) / 2), *loaded)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto test_octree_compaction() -> bool {
+    const auto block_types = make_block_types();
+    auto world = make_world(block_types);
+
+    std::vector<std::unique_ptr<Chunk>> originals;
+    for (const auto& chunk : world._chunks) {
+        originals.push_back(std::make_unique<Chunk>(*chunk));
+    }
+
+    for (const auto& original : originals) {
+        if (!compact_chunk(world, original->_position) || find_chunk(world, original->_position)) {
+            return false;
+        }
+
+        const auto expanded = expand_chunk(world, original->_position);
+        if (!expanded || !is_same_blocks(*original, *expanded)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto test_recording() -> bool {
+    using namespace Application;
+
+    ReplayFrames frames = make_replay_path(ReplayPath::Spiral, 64, 1.0f / 60.0f);
+    for (size_t i = 0; i < std::size(frames); i++) {
+        auto& frame = frames[i];
+        frame.input.forward = i % 2 == 0;
+        frame.input.jump = i % 5 == 0;
+        frame.input.button_right = i % 7 == 0;
+        frame.direction = glm::normalize(vec3 { std::sin(0.1f * static_cast<float>(i)), 0.3f, -std::cos(0.1f * static_cast<float>(i)) });
+        if (i % 3 == 0) {
+            frame.position.reset();
+        }
+    }
+
+    const auto path = get_scratch_path("recording.bin");
+    const auto loaded = save_recording(path, frames) ? load_recording(path) : std::nullopt;
+    std::filesystem::remove(path);
+    if (!loaded || std::size(*loaded) != std::size(frames)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < std::size(frames); i++) {
+        const auto& a = frames[i];
+        const auto& b = (*loaded)[i];
+        if (a.input.forward != b.input.forward || a.input.jump != b.input.jump || a.input.button_right != b.input.button_right
+            || std::abs(a.dt - b.dt) > 1e-5f || glm::length(a.direction - b.direction) > 1e-3f || a.position.has_value() != b.position.has_value()
+            || (a.position && *a.position != *b.position)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// A second compression of the same pixels must come from the cache and match the first
+auto test_texture_cache(Graphics::TextureFormat format) -> bool {
+    using namespace Graphics;
+
+    TextureInfo texture;
+    texture.width = 20;
+    texture.height = 12;
+    texture.channels = 4;
+    texture.name = "test";
+    texture.filepath = get_scratch_path(fmt::format("texture-{}.png", static_cast<int>(format)));
+    texture.pixels.resize(static_cast<size_t>(texture.width) * texture.height * texture.channels);
+    for (size_t i = 0; i < std::size(texture.pixels); i++) {
+        // Opaque pixels for BC1, a gradient of alpha for the others
+        texture.pixels[i] = i % 4 == 3 && format == TextureFormat::BC1 ? 255 : static_cast<uint8_t>((i * 37) ^ (i >> 3));
+    }
+
+    const auto settings
+        = CompressionSettings { .opaque_format = format, .alpha_format = format, .mipmaps = true, .use_cache = true, .keep_pixels = true, .threads = 2 };
+
+    TextureAtlas first { { texture } };
+    TextureAtlas second { { texture } };
+    const auto cached_first = compress_texture_atlas(first, settings);
+    const auto cached_second = compress_texture_atlas(second, settings);
+    std::filesystem::remove(texture.filepath + (format == TextureFormat::BC1 ? ".bc1" : (format == TextureFormat::BC3 ? ".bc3" : ".bc7")));
+
+    const auto& a = first._textures[0].compressed;
+    const auto& b = second._textures[0].compressed;
+    if (cached_first != 0 || cached_second != 1 || !a || !b || a->format != format || b->format != format || a->psnr != b->psnr
+        || std::size(a->levels) != std::size(b->levels) || std::size(a->levels) != 5) {
+        return false;
+    }
+
+    for (size_t l = 0; l < std::size(a->levels); l++) {
+        const auto& x = a->levels[l];
+        const auto& y = b->levels[l];
+        if (x.width != y.width || x.height != y.height || x.blocks != y.blocks) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+struct Test {
+    std::string_view name;
+    std::function<bool()> run;
+};
+
+} // namespace
+
+auto main() -> int {
+    using Graphics::TextureFormat;
+
+    const Test tests[] = {
+        { "mesh equivalence", test_mesh_equivalence },
+        { "chunk storage", test_chunk_storage },
+        { "octree compaction", test_octree_compaction },
+        { "recording", test_recording },
+        { "texture cache bc1", [] { return test_texture_cache(TextureFormat::BC1); } },
+        { "texture cache bc3", [] { return test_texture_cache(TextureFormat::BC3); } },
+        { "texture cache bc7", [] { return test_texture_cache(TextureFormat::BC7); } },
+    };
+
+    size_t failed = 0;
+    for (const auto& test : tests) {
+        const auto passed = test.run();
+        fmt::print("{} {}\n", passed ? "passed" : "FAILED", test.name);
+        failed += !passed;
+    }
+
+    return failed == 0 ? 0 : 1;
+}
\ No newline at end of file